@@ -2,68 +2,28 @@
 #define DRV8353_H
 
 #include <Arduino.h>
-
-struct RegisterInfo {
-    const char* name;
-    uint8_t address;
-};
+#include "drvRegisterMap.h"
 
 class DRV8353 {
 public:
-    String faultMessage;
-    enum class PWMMode : uint8_t {
-        SixPWM        = 0b00,
-        ThreePWM      = 0b01,
-        OnePWM        = 0b10,
-        IndependentPWM = 0b11
-    };
-    enum class RetryTime : uint8_t {
-        Retry8ms  = 0b0,
-        Retry50us = 0b1
-    };
-    enum class DeadTime : uint8_t {
-        DeadTime50ns  = 0b00,
-        DeadTime100ns = 0b01,
-        DeadTime200ns = 0b10,
-        DeadTime400ns = 0b11
-    };
-    enum class OcpMode : uint8_t {
-        Latched     = 0b00,
-        AutoRetry   = 0b01,
-        ReportOnly  = 0b10,
-        Disabled    = 0b11
-    };
-    enum class OcpDeglitch : uint8_t {
-        Deglitch1us = 0b00,
-        Deglitch2us = 0b01,
-        Deglitch4us = 0b10,
-        Deglitch8us = 0b11
-    };
-    enum class CsaGain : uint8_t {
-        Gain5VPerV  = 0b00,
-        Gain10VPerV = 0b01,
-        Gain20VPerV = 0b10,
-        Gain40VPerV = 0b11
-    };
-    enum class SenseOcpLevel : uint8_t {
-        Level025V = 0b00,
-        Level050V = 0b01,
-        Level075V = 0b10,
-        Level100V = 0b11
-    };
-    static constexpr RegisterInfo drvRegisters[] = {
-    {"FAULT_STATUS_1", 0x00},
-    {"VGS_STATUS_2", 0x01},
-    {"DRIVER_CONTROL", 0x02},
-    {"GATE_DRIVE_HS", 0x03},
-    {"GATE_DRIVE_LS", 0x04},
-    {"OCP_CONTROL",   0x05},
-    {"CSA_CONTROL",   0x06},
-    {"DRIVER_CONFIG", 0x07},
-    };
+    using PWMMode = DrvRegs::PWMMode;
+    using RetryTime = DrvRegs::RetryTime;
+    using DeadTime = DrvRegs::DeadTime;
+    using OcpMode = DrvRegs::OcpMode;
+    using OcpDeglitch = DrvRegs::OcpDeglitch;
+    using CsaGain = DrvRegs::CsaGain;
+    using SenseOcpLevel = DrvRegs::SenseOcpLevel;
     void init();
     static void checkFault();
+    /** Compare one control register with the intended value and repair it; call at a low rate. */
+    void scrubNextRegister();
+    /** False while a control register could not be restored; drive outputs stay off. */
+    bool isHealthy() const;
+    /** CSA gain in V/V as last read back from the chip. */
+    float senseGain() const;
     void send3PWMMotorSignal(uint16_t pwmA, uint16_t pwmB, uint16_t pwmC);
+    /** Drive or float each phase; a disabled phase has both FETs off (Hi-Z). */
+    void setPhaseEnables(bool a, bool b, bool c);
     #pragma region DRV8353ControlFunctions
     // Control Functions
     void clearFault();
@@ -92,6 +52,8 @@ public:
     void setHighSideSourceCurrentCode(uint8_t code);
     /** Program IDRIVEN_HS (sink) current code per Table 15 (0-15). */
     void setHighSideSinkCurrentCode(uint8_t code);
+    /** Program IDRIVEP_HS and IDRIVEN_HS in one register write. */
+    void setHighSideCurrentCodes(uint8_t sourceCode, uint8_t sinkCode);
     // Gate Drive LS
     /** Configure CBC behavior (true clears on next PWM edge). */
     void setCbcClearingByPwm(bool enabled);
@@ -101,6 +63,8 @@ public:
     void setLowSideSourceCurrentCode(uint8_t code);
     /** Program IDRIVEN_LS (sink) current code per Table 16 (0-15). */
     void setLowSideSinkCurrentCode(uint8_t code);
+    /** Program IDRIVEP_LS and IDRIVEN_LS in one register write. */
+    void setLowSideCurrentCodes(uint8_t sourceCode, uint8_t sinkCode);
     // OCP Control
     /** Select retry timing for VDS_OCP and SEN_OCP faults. */
     void setRetryTime(RetryTime retryTime);
@@ -129,6 +93,8 @@ public:
     void calibrateSenseAmpB(bool enable);
     /** Short sense amplifier C inputs for offset calibration. */
     void calibrateSenseAmpC(bool enable);
+    /** Short or release all three amplifier inputs in one register write. */
+    void calibrateSenseAmps(bool enable);
     /** Set the CSA sense overcurrent threshold. */
     void setSenseOcpThreshold(SenseOcpLevel level);
     // Driver Configuration
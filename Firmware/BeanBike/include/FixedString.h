@@ -0,0 +1,47 @@
+#ifndef FIXED_STRING_H
+#define FIXED_STRING_H
+
+#include <Arduino.h>
+#include <stdarg.h>
+#include <stdio.h>
+
+// Fixed-capacity text buffer for runtime formatting; truncates rather than touching the heap.
+// Floats go through dtostrf (the same formatting String(float, n) used), never printf's %f,
+// whose newlib implementation allocates.
+template <size_t N>
+class FixedString {
+public:
+    FixedString() { text[0] = '\0'; }
+
+    void append(const char* value) { appendf("%s", value); }
+    void append(char value) { appendf("%c", value); }
+    void appendFloat(float value, int decimals) {
+        char number[24];
+        append(dtostrf(value, decimals + 2, decimals, number));
+    }
+    void appendf(const char* format, ...) __attribute__((format(printf, 2, 3))) {
+        if (used + 1 >= N) {
+            return;
+        }
+        va_list args;
+        va_start(args, format);
+        const int written = vsnprintf(text + used, N - used, format, args);
+        va_end(args);
+        if (written > 0) {
+            used = used + written < N ? used + written : N - 1;
+        }
+    }
+    void clear() {
+        used = 0;
+        text[0] = '\0';
+    }
+
+    const char* c_str() const { return text; }
+    size_t length() const { return used; }
+
+private:
+    char text[N];
+    size_t used = 0;
+};
+
+#endif
@@ -0,0 +1,35 @@
+#ifndef MAILBOX_H
+#define MAILBOX_H
+
+#include <atomic>
+#include <stdint.h>
+
+// One pending value handed from one task to another; a newer post replaces an untaken one.
+// The receiver takes it at its own loop boundary, so the sender never touches its state.
+template <typename T>
+class Mailbox {
+    static_assert(sizeof(T) <= sizeof(uint32_t), "Mailbox values must be a single word");
+
+public:
+    /** Sender only. */
+    void post(T value) {
+        pendingValue.store(value, std::memory_order_relaxed);
+        pending.store(true, std::memory_order_release);
+    }
+
+    /** Receiver only; false when nothing was posted since the last take. */
+    bool take(T& value) {
+        if (!pending.exchange(false, std::memory_order_acquire)) {
+            return false;
+        }
+        // A post racing the exchange re-arms the flag; its value is taken again next time
+        value = pendingValue.load(std::memory_order_relaxed);
+        return true;
+    }
+
+private:
+    std::atomic<bool> pending{false};
+    std::atomic<T> pendingValue{};
+};
+
+#endif
@@ -0,0 +1,19 @@
+#ifndef PI_CONTROLLER_H
+#define PI_CONTROLLER_H
+
+
+class PIController {
+public:
+    float kp = 0.0f;
+    float ki = 0.0f;
+    float outputMin = 0.0f;
+    float outputMax = 1.0f;
+    float integral = 0.0f;
+
+    /** Preload the integrator so the next output equals `output` at zero error. */
+    void reset(float output = 0.0f, float feedForward = 0.0f);
+    /** Advance one step; the integrator stops winding while the output is saturated. */
+    float update(float error, float dtSec, float feedForward = 0.0f);
+};
+
+#endif
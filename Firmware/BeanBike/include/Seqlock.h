@@ -0,0 +1,43 @@
+#ifndef SEQLOCK_H
+#define SEQLOCK_H
+
+#include <atomic>
+#include <stdint.h>
+
+// Single-writer snapshot shared between cores. The writer never waits; a reader that
+// overlaps a write sees an odd or changed sequence and copies again.
+template <typename T>
+class Seqlock {
+public:
+    /** Publish a new value; only one task may write. */
+    void write(const T& value) {
+        const uint32_t start = sequence.load(std::memory_order_relaxed);
+        sequence.store(start + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        data = value;
+        sequence.store(start + 2, std::memory_order_release);
+    }
+
+    /** Coherent copy of the last published value. */
+    T read() const {
+        T copy;
+        uint32_t before;
+        uint32_t after;
+        do {
+            before = sequence.load(std::memory_order_acquire);
+            copy = data;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            after = sequence.load(std::memory_order_relaxed);
+        } while ((before & 1u) != 0 || before != after);
+        return copy;
+    }
+
+    /** Changes on every write; even while no write is in progress. */
+    uint32_t version() const { return sequence.load(std::memory_order_acquire); }
+
+private:
+    std::atomic<uint32_t> sequence{0};
+    T data{};
+};
+
+#endif
@@ -0,0 +1,38 @@
+#ifndef THROTTLE_SHAPER_H
+#define THROTTLE_SHAPER_H
+
+#include "config.h"
+
+struct ThrottleProfile {
+    const char* name;
+    float cutoffHz;        // Low-pass corner
+    float riseRatePerSec;  // Max increase in ratio per second
+    float fallRatePerSec;  // Max decrease in ratio per second
+    float expo;            // 0 = linear, 1 = fully cubic
+};
+
+class ThrottleShaper {
+public:
+    static constexpr int CURVE_POINTS = 33;
+    static constexpr int PROFILE_COUNT = 3;
+    static const ThrottleProfile PROFILES[PROFILE_COUNT];
+
+    /** Copy the named profile's settings into `target`; false if the name is unknown. */
+    static bool applyProfile(const char* name, Config& target);
+
+    /** Jump the whole pipeline to `ratio` without filtering or slewing. */
+    void reset(float ratio = 0.0f);
+    /** Expo curve, then two cascaded time-based low-pass stages, then rise/fall slew limits. */
+    float update(float rawRatio, float dtSec);
+
+private:
+    float lowPass1 = 0.0f;
+    float lowPass2 = 0.0f;
+    float output = 0.0f;
+    float curve[CURVE_POINTS];
+    float curveExpo = -1.0f;   // Expo the curve table was last built for
+
+    float applyCurve(float ratio);
+};
+
+#endif
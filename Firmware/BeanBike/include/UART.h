@@ -1,12 +1,27 @@
 #ifndef UART_H
 #define UART_H
 
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
 class UART {
 public:
     void init();
-    void sendMessage(String message);
-    void sendData(String name, String data);
+    void sendMessage(const char* message);
+    /** From the queued task this goes through the telemetry queue; elsewhere it prints directly. */
+    void sendData(const char* name, const char* data);
+    // Numeric values are formatted into stack buffers; nothing here allocates
+    void sendData(const char* name, float value, int decimals = 2);
+    void sendData(const char* name, int value) { sendData(name, static_cast<long>(value)); }
+    void sendData(const char* name, unsigned int value) { sendData(name, static_cast<unsigned long>(value)); }
+    void sendData(const char* name, long value);
+    void sendData(const char* name, unsigned long value);
     void receiveCommand();
+    /** Route sendData calls made by `task` through the lock-free telemetry queue. */
+    void setQueuedTask(TaskHandle_t task) { queuedTask = task; }
+
+private:
+    TaskHandle_t queuedTask = nullptr;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,49 @@
+#ifndef ADC_H
+#define ADC_H
+
+#include <stdint.h>
+#include "Seqlock.h"
+
+enum class AdcChannel : uint8_t {
+    Throttle,
+    Battery,
+    SenseA,
+    SenseB,
+    SenseC,
+    PhaseVoltA,
+    PhaseVoltB,
+    PhaseVoltC,
+    Count
+};
+
+struct AdcSnapshot {
+    float volts[static_cast<int>(AdcChannel::Count)];
+    uint32_t sequence;        // Increments once per published DMA frame
+    uint32_t timestampMicros;
+};
+
+class Adc {
+public:
+    static constexpr int TABLE_BITS = 12;
+    static constexpr int TABLE_SIZE = 1 << TABLE_BITS;
+    static constexpr int CHANNEL_COUNT = static_cast<int>(AdcChannel::Count);
+
+    /** Build the calibration table and start continuous DMA conversion of all channels. */
+    void init();
+    /** Block on the next DMA frame; false on timeout or when DMA is not running. */
+    bool readFrame();
+    /** Filter the frame just read per channel and publish it as a new snapshot. */
+    void publishFrame();
+    /** Copy of the most recently published snapshot; never waits on the converter. */
+    AdcSnapshot snapshot() const;
+    /** Latest filtered voltage of a single channel. */
+    float readVolts(AdcChannel channel) const;
+    /** False when DMA is not running or a channel the current loop needs has no ADC1 input. */
+    bool ready() const { return requiredChannelsReady; }
+
+private:
+    Seqlock<AdcSnapshot> published;
+    bool requiredChannelsReady = false;
+};
+
+#endif
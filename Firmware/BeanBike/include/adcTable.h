@@ -0,0 +1,27 @@
+#ifndef ADC_TABLE_H
+#define ADC_TABLE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Count->millivolt table generator, kept free of IDF headers so it is unit-tested on the host
+// (test/test_adc_table). The converter is evaluated once per count; the result is clamped to
+// uint16 and forced non-decreasing, so a rounding wobble in the characterization curve can
+// never make a higher count read as a lower voltage.
+template <typename Converter>
+void buildCountTable(uint16_t* table, size_t size, Converter toMillivolts) {
+    uint32_t previous = 0;
+    for (size_t raw = 0; raw < size; ++raw) {
+        uint32_t millivolts = toMillivolts(static_cast<uint32_t>(raw));
+        if (millivolts > UINT16_MAX) {
+            millivolts = UINT16_MAX;
+        }
+        if (raw > 0 && millivolts < previous) {
+            millivolts = previous;
+        }
+        table[raw] = static_cast<uint16_t>(millivolts);
+        previous = millivolts;
+    }
+}
+
+#endif
@@ -1,12 +1,15 @@
 #ifndef BATTERY_H
 #define BATTERY_H
 
+#include <stdint.h>
 
 class Battery {
 public:
-    float voltage;
+    volatile float voltage; // Latest decimated value, written only by the ADC task
     float level;
 
+    /** Add one DMA frame's battery conversions; ADC task only. */
+    void accumulate(uint32_t millivoltSum, uint32_t sampleCount);
     float getBatteryVoltage();
     float getBatteryLevel();
     void updateBatteryStatus();
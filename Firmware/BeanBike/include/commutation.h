@@ -0,0 +1,65 @@
+#ifndef COMMUTATION_H
+#define COMMUTATION_H
+
+#include <stdint.h>
+#include "adc.h"
+
+enum class CommutationMode : uint8_t {
+    Hall,
+    Sensorless,
+    Fault      // No usable position source; the bridge is held off
+};
+
+class Commutation {
+public:
+    static constexpr uint8_t INVALID_SECTOR = 0xFF;
+    static constexpr int MODE_COUNT = 2; // Modes that can drive the motor
+
+    /** Read the halls, watch their sequence and pick the sector to drive; falls back to back-EMF when they fail. */
+    void update(const AdcSnapshot& inputs, float busVoltage, float rpm);
+    /** Six-step drive of the current sector: PWM on the high phase, low side on, third phase floating. */
+    void drive(uint16_t pwm);
+    /** Six-step drive of an explicit sector regardless of the halls; used by hall learning. */
+    void driveSector(uint8_t sector, uint16_t pwm);
+    /** Current through the energised phase pair of the active step: positive motoring, negative braking. */
+    float pairCurrent(const float phaseAmps[3]) const;
+    /** Add one control interval of electrical power and travel to the active mode's efficiency totals. */
+    void accumulateEfficiency(float powerW, float mph, float dtSec);
+    /** Watt-hours per mile driven in `mode`, 0 until it has covered some distance. */
+    float whPerMile(CommutationMode mode) const;
+    /** Hall code (C:B:A) of the last read. */
+    uint8_t hallState() const { return lastHallState; }
+    /** Electrical steps counted by whichever source is commutating. */
+    uint32_t edgeCount() const { return edgeTotal; }
+    uint32_t hallErrors() const { return hallErrorCount; }
+    CommutationMode mode() const { return activeMode; }
+    static const char* modeName(CommutationMode mode);
+
+private:
+    CommutationMode activeMode = CommutationMode::Hall;
+    uint8_t sector = 0;
+    uint8_t lastHallState = 0;
+    uint8_t lastHallSector = INVALID_SECTOR;
+    uint8_t hallErrorRun = 0;     // Consecutive bad hall events
+    uint16_t hallValidRun = 0;    // Consecutive good hall transitions
+    uint32_t hallErrorCount = 0;
+    uint32_t lastHallEdges = 0;
+    uint32_t edgeTotal = 0;
+
+    // Sensorless state
+    uint32_t lastStepMicros = 0;
+    uint32_t stepPeriodMicros = 0;
+    uint32_t zeroCrossMicros = 0;
+    bool commutationPending = false;
+    uint32_t lastAdcSequence = 0;
+
+    float energyJoules[MODE_COUNT] = {0.0f, 0.0f};
+    float distanceMiles[MODE_COUNT] = {0.0f, 0.0f};
+
+    void setMode(CommutationMode mode);
+    bool monitorHalls(uint8_t hallSector, uint32_t newEdges, bool stateChanged);
+    void enterSensorless(float rpm);
+    void updateSensorless(const AdcSnapshot& inputs, float busVoltage);
+};
+
+#endif
@@ -1,36 +1,114 @@
 #ifndef CONFIG_H
 #define CONFIG_H
 
+#include <stdint.h>
 
 class Config {
 public:
+    static constexpr int PAS_LEVEL_COUNT = 6;    // Level 0 = assist off
+    static constexpr int PAS_CADENCE_POINTS = 5;
+
     //Bike
     int wheelDiameterInches = 26;
 
     //PAS
     int pasPulsesPerRev = 12; // Change when we know the actual number of PAS magnets
+    float pasMinCadenceRpm = 10.0f; // Slower pedaling is treated as stopped
+    bool pasQuadrature = false; // Two-channel PAS sensor with SENSOR_PAS_DIR wired; PCNT picks this up at boot
+    bool pasDirectionInverted = false; // Swap if forward pedaling reads as backpedal
+    float pasGlitchFilterUs = 12.0f; // PCNT filter, max ~12.7 us
+    // Assist map: level x cadence -> fraction of maxPhaseCurrentAmps, bilinearly interpolated
+    float pasCadenceBreakpointsRpm[PAS_CADENCE_POINTS] = {0.0f, 30.0f, 60.0f, 90.0f, 120.0f};
+    float pasAssistMap[PAS_LEVEL_COUNT][PAS_CADENCE_POINTS] = {
+        {0.00f, 0.00f, 0.00f, 0.00f, 0.00f},
+        {0.10f, 0.20f, 0.25f, 0.25f, 0.22f},
+        {0.16f, 0.32f, 0.40f, 0.40f, 0.36f},
+        {0.24f, 0.48f, 0.60f, 0.60f, 0.54f},
+        {0.32f, 0.64f, 0.80f, 0.80f, 0.72f},
+        {0.40f, 0.80f, 1.00f, 1.00f, 0.90f},
+    };
 
     //Motor
     int maxMotorWattage = 1000;
     float maxMotorRPM = 600.0f;
+    float hallGlitchFilterUs = 5.0f; // PCNT filter on hall edges, max ~12.7 us
+    int hallEdgesPerRev = 138;       // Hall edges (all sensors, both edges) per wheel revolution
+
+    // Commutation
+    uint8_t hallSectorTable[8] = {0xFF, 0, 2, 1, 4, 5, 3, 0xFF}; // Hall code (C:B:A) -> six-step sector; MOTOR LEARN_HALLS
+    bool hallSequenceForward = true;  // Hall codes advance 1,3,2,6,4,5 while motoring forward
+    float hallLearnDuty = 0.06f;      // Open-loop duty while aligning the rotor
+    float hallLearnMaxAmps = 8.0f;    // Learning aborts above this phase current
+    uint32_t hallLearnSettleMs = 200; // Time for the rotor to settle on each step
+    int hallLearnCycles = 2;          // Electrical revolutions stepped; every cycle must agree
+    uint8_t hallFaultThreshold = 3;   // Consecutive bad hall events before falling back to sensorless
+    uint16_t hallRecoveryEdges = 60;  // Consecutive good transitions before trusting the halls again
+    int commutationOverride = 0;      // 0 = auto, 1 = hall only, 2 = sensorless only
+    float sensorlessMinRpm = 60.0f;   // Back-EMF too small to detect below this
+    float sensorlessBlanking = 0.25f; // Fraction of a step ignored after each commutation
+    float phaseVoltageDividerRatio = 19.0f;
+
+    // Current (torque) control
+    float maxPhaseCurrentAmps = 30.0f;   // Setpoint at full throttle / assist
+    float maxBatteryCurrentAmps = 20.0f;
+    float currentLoopKp = 0.01f;         // Duty per amp of error
+    float currentLoopKi = 0.5f;          // Duty per amp-second of error
+
+    // Regenerative braking; the current loop gains are shared with drive
+    bool regenEnabled = true;             // false = the brake lever only trips the MCPWM outputs cycle by cycle and the bridge coasts Hi-Z
+    float regenBrakeAmps = 15.0f;         // Phase current with the brake lever pulled
+    float regenThrottleBackAmps = 0.0f;   // Phase current with throttle released, 0 = coast
+    float regenMaxPhaseCurrentAmps = 20.0f;
+    float regenMaxBatteryAmps = 5.0f;     // Charge current ceiling
+    float regenVoltageCeiling = 54.6f;    // Bus voltage at which regen reaches zero
+    float regenVoltageTaper = 1.0f;       // Volts below the ceiling over which regen fades out
+    float regenMinRpm = 30.0f;            // Too little back-EMF to brake below this
+    float regenBackEmfMargin = 0.1f;      // Duty ceiling kept this fraction below the estimated back-EMF duty
+    float regenMotoringTripAmps = 2.0f;   // Motoring current while braking; regen coasts instead
+
+    // Cruise control speed loop
+    float cruiseSpeedKp = 0.05f;         // Amps per rpm of error
+    float cruiseSpeedKi = 0.1f;          // Amps per rpm-second of error
 
     // ADC configuration
-    int adcResolutionBits = 12;
-    float adcReferenceVoltage = 3.3f;
+    uint32_t adcSampleRateHz = 20000; // Total DMA conversions per second, shared by all channels
+    float adcFilterAlpha[8] = {1.0f, 0.05f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f}; // Per-frame EMA weight: throttle, battery, SOA, SOB, SOC, VSENSE A/B/C
 
     // Shunt amplifier configuration
     float shuntResistanceMilliOhm = 1.0f; // mΩ
     float currentSenseGain = 0.0f;       // CSA_GAIN; Set when initializing DRV8353
-    float currentSenseOffsetVolt = 1.65f;
+    float currentSenseOffsetVolt[3] = {1.65f, 1.65f, 1.65f}; // Per phase A/B/C; measured at boot
+    int currentSenseCalSamples = 16;                          // DMA frames averaged per phase
+    uint32_t currentSenseRecalIntervalMs = 60000;             // Idle recalibration period, 0 = boot only
+
+    // Control loop deadline
+    uint32_t controlCycleBudgetUs = 800;   // Work allowed per 1 ms cycle
+    uint8_t controlMaxMissedDeadlines = 3; // Consecutive misses (or one stall this long) before forcing coast
+    uint16_t controlRecoveryCycles = 100;  // On-time cycles before a deadline trip is released
+    uint32_t controlWatchdogTimeoutSec = 1;
+
+    // Gate PWM
+    uint32_t pwmFrequencyHz = 20000;
+    float pwmDeadTimeNs = 200.0f;        // MCPWM dead time between INHx and INLx edges
+
+    // DRV8353
+    uint32_t drvSpiClockHz = 10000000; // DRV8353 SCLK limit is 10 MHz
 
     // Battery
     float batteryVoltageDividerRatio = 19.0f;
+    int batteryOversampleCount = 16;   // Battery conversions summed per decimation tick
+    int batteryDecimationFactor = 8;   // Ticks averaged per published voltage
 
     // Throttle
     float throttleMinVoltage = 0.9f;
     float throttleMaxVoltage = 3.2f;
     float throttleDeadband = 0.05f;
-    float throttleFilterAlpha = 0.2f; // 0..1 EMA weight
+    // Throttle shaping; the defaults are the NORMAL profile
+    int throttleProfile = 1;              // Index into ThrottleShaper::PROFILES
+    float throttleCutoffHz = 4.0f;        // 0 = no low-pass
+    float throttleRiseRatePerSec = 1.5f;  // 0 = no slew limit
+    float throttleFallRatePerSec = 4.0f;
+    float throttleExpo = 0.3f;            // 0 = linear, 1 = cubic
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,37 @@
+#ifndef CONFIG_STORE_H
+#define CONFIG_STORE_H
+
+#include <stdint.h>
+#include "config.h"
+#include "Seqlock.h"
+
+// The control task owns the global `config`. Other tasks edit a staged copy that is
+// applied at the top of the next control cycle, and read a published copy.
+// Fields the control task measures or learns itself survive an apply unless the edit
+// changed them, so a SET staged from an older snapshot cannot roll them back.
+class ConfigStore {
+public:
+    /** Publish the active config for other tasks; control task only. */
+    void publish();
+    /** Take a submitted edit into the active config; call at the loop boundary. */
+    bool apply();
+    /** Coherent copy of the active config as of the last publish. */
+    Config snapshot() const { return published.read(); }
+    /** Start an edit from the published config; only the UART task edits. */
+    Config& beginEdit();
+    /** Hand the edit to the control task if it changed a field; takes effect at the next loop boundary. */
+    bool submit();
+
+private:
+    struct Edit {
+        Config base;    // Published config the edit started from
+        Config edited;
+    };
+
+    Seqlock<Config> published;
+    Seqlock<Edit> pending;
+    Edit staging;
+    uint32_t appliedVersion = 0;
+};
+
+#endif
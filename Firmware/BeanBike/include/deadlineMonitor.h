@@ -0,0 +1,41 @@
+#ifndef DEADLINE_MONITOR_H
+#define DEADLINE_MONITOR_H
+
+#include <stdint.h>
+#include <esp_timer.h>
+
+// Control cycle deadline checks. The control task times its own cycles; a periodic
+// esp_timer on the other core catches a cycle that never finishes. Either one can force
+// the bridge into coast through the MCPWM trip zone, which needs no SPI and no control task.
+class DeadlineMonitor {
+public:
+    /** Subscribe the calling (control) task to the task watchdog and start the stall timer. */
+    void init();
+    void beginCycle();
+    /** Time the cycle, count a miss if it ran over budget and feed the task watchdog. */
+    void endCycle();
+    /** The current cycle is expected to run long with the bridge off; do not count it. */
+    void excuseCycle() { excused = true; }
+    /** Keep the task watchdog quiet inside an excused cycle's own wait loops. */
+    void feedWatchdog();
+    /** Send worst cycle time over the last window, overrun and trip counts. */
+    void report();
+
+private:
+    volatile uint32_t cycleStartMicros = 0;
+    volatile bool inCycle = false;
+    volatile bool excused = false;
+    volatile bool stallTripped = false;   // Set by the stall timer, picked up by endCycle
+    volatile uint32_t worstCycleMicros = 0;
+    volatile uint32_t overruns = 0;
+    volatile uint32_t trips = 0;
+    uint8_t consecutiveMisses = 0;
+    uint16_t onTimeCycles = 0;
+    bool tripped = false;
+    esp_timer_handle_t stallTimer = nullptr;
+
+    void trip();
+    static void checkStall(void* parameter);
+};
+
+#endif
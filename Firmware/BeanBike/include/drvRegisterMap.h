@@ -0,0 +1,236 @@
+#ifndef DRV_REGISTER_MAP_H
+#define DRV_REGISTER_MAP_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// DRV8353 register map as compile-time field descriptions. Every field knows its register,
+// bit position, width and value type, so a write encodes to one constant mask and shift,
+// several fields of a register combine into a single write, and the runtime FIELD_TABLE
+// used by the fault decoder and the register pretty-printer is built from the same types.
+// Kept free of Arduino headers so host tools can include it.
+
+struct RegisterInfo {
+    const char* name;
+    uint8_t address;
+};
+
+namespace DrvRegs {
+
+constexpr RegisterInfo REGISTERS[] = {
+    {"FAULT_STATUS_1", 0x00},
+    {"VGS_STATUS_2",   0x01},
+    {"DRIVER_CONTROL", 0x02},
+    {"GATE_DRIVE_HS",  0x03},
+    {"GATE_DRIVE_LS",  0x04},
+    {"OCP_CONTROL",    0x05},
+    {"CSA_CONTROL",    0x06},
+    {"DRIVER_CONFIG",  0x07},
+};
+constexpr size_t REGISTER_COUNT = sizeof(REGISTERS) / sizeof(REGISTERS[0]);
+constexpr uint16_t DATA_MASK = 0x07FF;  // 11 data bits per frame
+
+enum class PWMMode : uint8_t {
+    SixPWM        = 0b00,
+    ThreePWM      = 0b01,
+    OnePWM        = 0b10,
+    IndependentPWM = 0b11
+};
+enum class LockCode : uint8_t {
+    Unlock = 0b011,
+    Lock   = 0b110
+};
+enum class RetryTime : uint8_t {
+    Retry8ms  = 0b0,
+    Retry50us = 0b1
+};
+enum class DeadTime : uint8_t {
+    DeadTime50ns  = 0b00,
+    DeadTime100ns = 0b01,
+    DeadTime200ns = 0b10,
+    DeadTime400ns = 0b11
+};
+enum class OcpMode : uint8_t {
+    Latched     = 0b00,
+    AutoRetry   = 0b01,
+    ReportOnly  = 0b10,
+    Disabled    = 0b11
+};
+enum class OcpDeglitch : uint8_t {
+    Deglitch1us = 0b00,
+    Deglitch2us = 0b01,
+    Deglitch4us = 0b10,
+    Deglitch8us = 0b11
+};
+enum class CsaGain : uint8_t {
+    Gain5VPerV  = 0b00,
+    Gain10VPerV = 0b01,
+    Gain20VPerV = 0b10,
+    Gain40VPerV = 0b11
+};
+enum class SenseOcpLevel : uint8_t {
+    Level025V = 0b00,
+    Level050V = 0b01,
+    Level075V = 0b10,
+    Level100V = 0b11
+};
+
+/** One field of a register; encode/decode are constant shifts and masks. */
+template <uint8_t Address, uint8_t Offset, uint8_t Width, typename T = uint8_t>
+struct Field {
+    static_assert(Width > 0 && Offset + Width <= 11, "field must fit in the 11 data bits");
+    typedef T Type;
+    static constexpr uint8_t ADDRESS = Address;
+    static constexpr uint8_t OFFSET = Offset;
+    static constexpr uint8_t WIDTH = Width;
+    static constexpr uint16_t MAX = static_cast<uint16_t>((1u << Width) - 1);
+    static constexpr uint16_t MASK = static_cast<uint16_t>(MAX << Offset);
+
+    static constexpr uint16_t encode(T value) {
+        return static_cast<uint16_t>((static_cast<uint16_t>(value) & MAX) << Offset);
+    }
+    static constexpr T decode(uint16_t reg) {
+        return static_cast<T>((reg >> Offset) & MAX);
+    }
+};
+
+/** Several fields of one register written together: one mask, one encoded value. */
+template <typename... Fields>
+struct FieldSet;
+
+template <typename F>
+struct FieldSet<F> {
+    static constexpr uint8_t ADDRESS = F::ADDRESS;
+    static constexpr uint16_t MASK = F::MASK;
+    static constexpr uint16_t encode(typename F::Type value) { return F::encode(value); }
+};
+
+template <typename F, typename... Rest>
+struct FieldSet<F, Rest...> {
+    static_assert(F::ADDRESS == FieldSet<Rest...>::ADDRESS, "fields must share a register");
+    static_assert((F::MASK & FieldSet<Rest...>::MASK) == 0, "fields overlap");
+    static constexpr uint8_t ADDRESS = F::ADDRESS;
+    static constexpr uint16_t MASK = F::MASK | FieldSet<Rest...>::MASK;
+    static constexpr uint16_t encode(typename F::Type value, typename Rest::Type... rest) {
+        return static_cast<uint16_t>(F::encode(value) | FieldSet<Rest...>::encode(rest...));
+    }
+};
+
+namespace FaultStatus1 {
+constexpr uint8_t ADDRESS = 0x00;
+typedef Field<ADDRESS, 10, 1, bool> Fault;
+typedef Field<ADDRESS, 9, 1, bool> VdsOcp;
+typedef Field<ADDRESS, 8, 1, bool> Gdf;
+typedef Field<ADDRESS, 7, 1, bool> Uvlo;
+typedef Field<ADDRESS, 6, 1, bool> Otsd;
+typedef Field<ADDRESS, 5, 1, bool> VdsHa;
+typedef Field<ADDRESS, 4, 1, bool> VdsLa;
+typedef Field<ADDRESS, 3, 1, bool> VdsHb;
+typedef Field<ADDRESS, 2, 1, bool> VdsLb;
+typedef Field<ADDRESS, 1, 1, bool> VdsHc;
+typedef Field<ADDRESS, 0, 1, bool> VdsLc;
+}
+
+namespace VgsStatus2 {
+constexpr uint8_t ADDRESS = 0x01;
+typedef Field<ADDRESS, 10, 1, bool> SaOc;
+typedef Field<ADDRESS, 9, 1, bool> SbOc;
+typedef Field<ADDRESS, 8, 1, bool> ScOc;
+typedef Field<ADDRESS, 7, 1, bool> Otw;
+typedef Field<ADDRESS, 6, 1, bool> Gduv;
+typedef Field<ADDRESS, 5, 1, bool> VgsHa;
+typedef Field<ADDRESS, 4, 1, bool> VgsLa;
+typedef Field<ADDRESS, 3, 1, bool> VgsHb;
+typedef Field<ADDRESS, 2, 1, bool> VgsLb;
+typedef Field<ADDRESS, 1, 1, bool> VgsHc;
+typedef Field<ADDRESS, 0, 1, bool> VgsLc;
+}
+
+namespace DriverControl {
+constexpr uint8_t ADDRESS = 0x02;
+typedef Field<ADDRESS, 10, 1, bool> OcpAct;
+typedef Field<ADDRESS, 9, 1, bool> DisGduv;
+typedef Field<ADDRESS, 8, 1, bool> DisGdf;
+typedef Field<ADDRESS, 7, 1, bool> OtwRep;
+typedef Field<ADDRESS, 5, 2, PWMMode> PwmMode;
+typedef Field<ADDRESS, 4, 1, bool> OnePwmCom;
+typedef Field<ADDRESS, 3, 1, bool> OnePwmDir;
+typedef Field<ADDRESS, 2, 1, bool> Coast;
+typedef Field<ADDRESS, 1, 1, bool> Brake;
+typedef Field<ADDRESS, 0, 1, bool> ClrFlt;
+}
+
+namespace GateDriveHs {
+constexpr uint8_t ADDRESS = 0x03;
+typedef Field<ADDRESS, 8, 3, LockCode> Lock;
+typedef Field<ADDRESS, 4, 4> IdriveP;
+typedef Field<ADDRESS, 0, 4> IdriveN;
+}
+
+namespace GateDriveLs {
+constexpr uint8_t ADDRESS = 0x04;
+typedef Field<ADDRESS, 10, 1, bool> CbcClear;
+typedef Field<ADDRESS, 8, 2> Tdrive;
+typedef Field<ADDRESS, 4, 4> IdriveP;
+typedef Field<ADDRESS, 0, 4> IdriveN;
+}
+
+namespace OcpControl {
+constexpr uint8_t ADDRESS = 0x05;
+typedef Field<ADDRESS, 10, 1, RetryTime> Tretry;
+typedef Field<ADDRESS, 8, 2, DeadTime> DeadTimeSel;
+typedef Field<ADDRESS, 6, 2, OcpMode> Mode;
+typedef Field<ADDRESS, 4, 2, OcpDeglitch> Deglitch;
+typedef Field<ADDRESS, 0, 4> VdsLevel;
+}
+
+namespace CsaControl {
+constexpr uint8_t ADDRESS = 0x06;
+typedef Field<ADDRESS, 10, 1, bool> CsaFet;
+typedef Field<ADDRESS, 9, 1, bool> VrefDiv;
+typedef Field<ADDRESS, 8, 1, bool> LsRef;
+typedef Field<ADDRESS, 6, 2, CsaGain> Gain;
+typedef Field<ADDRESS, 5, 1, bool> DisSen;
+typedef Field<ADDRESS, 4, 1, bool> CalA;
+typedef Field<ADDRESS, 3, 1, bool> CalB;
+typedef Field<ADDRESS, 2, 1, bool> CalC;
+typedef Field<ADDRESS, 0, 2, SenseOcpLevel> SenLevel;
+}
+
+namespace DriverConfig {
+constexpr uint8_t ADDRESS = 0x07;
+typedef Field<ADDRESS, 0, 1, bool> CalMode;
+}
+
+/** Runtime view of a field, for decoders and printers that walk the whole map. */
+struct FieldInfo {
+    const char* name;
+    const char* description;
+    const char* const* valueNames;  // Indexed by raw field value; null for numeric fields
+    uint8_t address;
+    uint8_t offset;
+    uint8_t width;
+};
+
+template <typename F>
+constexpr FieldInfo describe(const char* name, const char* description, const char* const* valueNames = nullptr) {
+    return FieldInfo{name, description, valueNames, F::ADDRESS, F::OFFSET, F::WIDTH};
+}
+
+/** Every field of the map, registers in address order and fields MSB first. */
+extern const FieldInfo FIELD_TABLE[];
+extern const size_t FIELD_COUNT;
+
+extern const char* const PWM_MODE_NAMES[];
+
+/** Raw value of a described field within a register word. */
+inline uint16_t fieldValue(const FieldInfo& field, uint16_t reg) {
+    return static_cast<uint16_t>((reg >> field.offset) & ((1u << field.width) - 1));
+}
+
+/** Write "NAME=value NAME=value ..." for every field of the register; returns the length. */
+size_t formatRegister(uint8_t address, uint16_t reg, char* out, size_t size);
+
+} // namespace DrvRegs
+
+#endif
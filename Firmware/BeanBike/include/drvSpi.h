@@ -0,0 +1,49 @@
+#ifndef DRV_SPI_H
+#define DRV_SPI_H
+
+#include <stdint.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/task.h>
+#include <driver/spi_master.h>
+
+/** Runs on the transport task with the 16-bit response to a queued frame; may submit, never transfer. */
+typedef void (*DrvSpiCallback)(uint16_t response, void* context);
+
+// DRV8353 SPI transport: 16-bit frames queued from any task or ISR, clocked out by the
+// ESP-IDF SPI master with DMA and hardware CS from a single transport task
+class DrvSpi {
+public:
+    static constexpr int QUEUE_DEPTH = 16;
+    static constexpr int BATCH_SIZE = 4;   // Frames in flight on the bus at once
+
+    /** Set up the bus, attach the device and start the transport task. */
+    bool init();
+    /** Queue a frame without waiting; `callback` may be null. */
+    bool submit(uint16_t frame, DrvSpiCallback callback, void* context);
+    /** ISR-safe variant of submit. */
+    bool submitFromIsr(uint16_t frame, DrvSpiCallback callback, void* context);
+    /** Queue a frame and sleep until its response arrives; returns 0 and counts an error on timeout. */
+    uint16_t transfer(uint16_t frame);
+    /** As transfer, but reports whether the response actually arrived. */
+    bool tryTransfer(uint16_t frame, uint16_t& response);
+    uint32_t errors() const { return errorCount; }
+
+private:
+    struct Request {
+        uint16_t frame;
+        uint16_t sequence;     // Matches a synchronous waiter to its own response
+        DrvSpiCallback callback;
+        void* context;
+        TaskHandle_t waiter;   // Synchronous caller to notify instead of a callback
+    };
+
+    QueueHandle_t requests = nullptr;
+    spi_device_handle_t device = nullptr;
+    volatile uint32_t errorCount = 0;
+
+    static void transportTask(void* parameter);
+    void runBatch(Request* batch, int count);
+};
+
+#endif
@@ -0,0 +1,125 @@
+#ifndef FAST_GPIO_H
+#define FAST_GPIO_H
+
+#include <stdint.h>
+
+// Compile-time GPIO access: the pin number is a template argument, so a read is one load of
+// the input register and a mask, with none of digitalRead's pin-table lookups. Pins sharing
+// a register bank can be read together in a single load. Safe to call from IRAM ISRs.
+//
+// Without ARDUINO the banks are plain variables (see FastGpio::setMockInput), so code using
+// these pins compiles and runs on a host.
+
+#define FAST_GPIO_INLINE inline __attribute__((always_inline))
+
+#ifdef ARDUINO
+#include <soc/gpio_struct.h>
+
+namespace FastGpio {
+/** GPIO0-31 live in bank 0, GPIO32-39 in bank 1. */
+FAST_GPIO_INLINE uint32_t readInputs(bool highBank) {
+    return highBank ? GPIO.in1.val : GPIO.in;
+}
+FAST_GPIO_INLINE void setOutputs(bool highBank, uint32_t mask) {
+    if (highBank) {
+        GPIO.out1_w1ts.val = mask;
+    } else {
+        GPIO.out_w1ts = mask;
+    }
+}
+FAST_GPIO_INLINE void clearOutputs(bool highBank, uint32_t mask) {
+    if (highBank) {
+        GPIO.out1_w1tc.val = mask;
+    } else {
+        GPIO.out_w1tc = mask;
+    }
+}
+} // namespace FastGpio
+
+#else
+// Arduino pin-mode values, so pins.h compiles on the host
+#ifndef INPUT
+#define INPUT 0x01
+#define OUTPUT 0x03
+#define INPUT_PULLUP 0x05
+#endif
+
+namespace FastGpio {
+struct MockBanks {
+    uint32_t in[2];
+    uint32_t out[2];
+};
+inline MockBanks& mockBanks() {
+    static MockBanks banks = {};
+    return banks;
+}
+/** Drive a simulated input level. */
+inline void setMockInput(int pin, bool level) {
+    uint32_t& bank = mockBanks().in[pin >= 32];
+    const uint32_t mask = 1u << (pin & 31);
+    bank = level ? (bank | mask) : (bank & ~mask);
+}
+/** Level last written to a simulated output. */
+inline bool mockOutput(int pin) {
+    return (mockBanks().out[pin >= 32] >> (pin & 31)) & 1u;
+}
+inline uint32_t readInputs(bool highBank) {
+    return mockBanks().in[highBank];
+}
+inline void setOutputs(bool highBank, uint32_t mask) {
+    mockBanks().out[highBank] |= mask;
+}
+inline void clearOutputs(bool highBank, uint32_t mask) {
+    mockBanks().out[highBank] &= ~mask;
+}
+} // namespace FastGpio
+#endif
+
+/** One GPIO resolved at compile time. */
+template <int Pin>
+struct FastPin {
+    static_assert(Pin >= 0 && Pin <= 39, "not an ESP32 GPIO");
+    static constexpr bool HIGH_BANK = Pin >= 32;
+    static constexpr uint32_t MASK = 1u << (Pin & 31);
+
+    static FAST_GPIO_INLINE bool read() {
+        return (FastGpio::readInputs(HIGH_BANK) & MASK) != 0;
+    }
+    static FAST_GPIO_INLINE void write(bool level) {
+        static_assert(Pin < 34, "GPIO34-39 are input-only");
+        if (level) {
+            FastGpio::setOutputs(HIGH_BANK, MASK);
+        } else {
+            FastGpio::clearOutputs(HIGH_BANK, MASK);
+        }
+    }
+};
+
+/** Several GPIOs in one bank, read with a single register load and packed first pin = bit 0. */
+template <int... Pins>
+struct FastPinGroup;
+
+template <>
+struct FastPinGroup<> {
+    static constexpr bool inBank(bool) { return true; }
+    static constexpr uint32_t pack(uint32_t, unsigned) { return 0; }
+};
+
+template <int First, int... Rest>
+struct FastPinGroup<First, Rest...> {
+    static_assert(First >= 0 && First <= 39, "not an ESP32 GPIO");
+    static_assert(FastPinGroup<Rest...>::inBank(First >= 32), "grouped pins must share a register bank");
+    static constexpr bool HIGH_BANK = First >= 32;
+
+    static constexpr bool inBank(bool highBank) {
+        return (First >= 32) == highBank && FastPinGroup<Rest...>::inBank(highBank);
+    }
+    static constexpr uint32_t pack(uint32_t bank, unsigned bit) {
+        return (((bank >> (First & 31)) & 1u) << bit) | FastPinGroup<Rest...>::pack(bank, bit + 1);
+    }
+    static FAST_GPIO_INLINE uint8_t read() {
+        return static_cast<uint8_t>(pack(FastGpio::readInputs(HIGH_BANK), 0));
+    }
+};
+
+#endif
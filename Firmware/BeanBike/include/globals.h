@@ -7,6 +7,15 @@
 #include "DRV8353.h"
 #include "battery.h"
 #include "config.h"
+#include "adc.h"
+#include "pulseCounter.h"
+#include "commutation.h"
+#include "configStore.h"
+#include "telemetry.h"
+#include "taskMonitor.h"
+#include "phasePwm.h"
+#include "deadlineMonitor.h"
+#include "heapGuard.h"
 
 extern Pins pins;
 extern Motor motor;
@@ -14,5 +23,14 @@ extern UART uart;
 extern DRV8353 drv8353;
 extern Battery battery;
 extern Config config;
+extern Adc adc;
+extern PulseCounter pulseCounter;
+extern Commutation commutation;
+extern ConfigStore configStore;
+extern Telemetry telemetry;
+extern TaskMonitor taskMonitor;
+extern PhasePwm phasePwm;
+extern DeadlineMonitor deadlineMonitor;
+extern HeapGuard heapGuard;
 
 #endif
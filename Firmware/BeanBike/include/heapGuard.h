@@ -0,0 +1,30 @@
+#ifndef HEAP_GUARD_H
+#define HEAP_GUARD_H
+
+#include <stdint.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+// Debug check that the control task never touches the heap once it is running. Only the
+// heap-guard build (env:esp32dev-heapguard) wraps malloc/calloc/realloc; elsewhere these are no-ops.
+class HeapGuard {
+public:
+    static constexpr uint32_t BOOT_CYCLES = 100; // Cycles allowed to allocate while things settle
+
+#ifdef HEAP_GUARD
+    /** Count allocations made by the calling task from now on. */
+    void watchCurrentTask();
+    /** Call once per control cycle; aborts at the allocating call site once BOOT_CYCLES have passed. */
+    void endCycle();
+    uint32_t allocations() const;
+#else
+    void watchCurrentTask() {}
+    void endCycle() {}
+    uint32_t allocations() const { return 0; }
+#endif
+
+private:
+    uint32_t cycles = 0;
+};
+
+#endif
@@ -1,6 +1,55 @@
 #ifndef MOTOR_H
 #define MOTOR_H
 
+#include <stdint.h>
+#include "Seqlock.h"
+#include "Mailbox.h"
+
+/** Which control path commanded the bridge this cycle. */
+enum class DriveSource : uint8_t {
+    None,
+    Throttle,
+    Pas,
+    Cruise,
+    Regen
+};
+
+// Everything other tasks may read about the motor, published once per control cycle
+struct MotorState {
+    float rpm;
+    float mph;
+    bool isCruiseControl;
+    float targetMph;
+    float cruiseErrorRmsMph;
+    float cruiseErrorMeanAbsMph;
+    float cruiseErrorMaxMph;
+    bool isPASMode;
+    int pasLevel;
+    float pasCadenceRpm;
+    bool pasBackpedaling;
+    float busVoltage;      // Battery voltage every cycle; lastBusVoltage holds only while driving
+    float lastBusVoltage;
+    float lastPhaseCurrent;
+    float lastElectricalPower;
+    float currentSetpointAmps;
+    float dutyCommand;
+    float throttleFilteredRatio;
+    uint8_t commutationMode;
+    uint8_t hallState;
+    uint32_t hallErrors;
+    float whPerMileHall;
+    float whPerMileSensorless;
+    bool brakeActive;
+    float throttleVoltage;
+    DriveSource driveSource;
+    float currentRequestAmps;  // Before the power or regen limit
+    int drivePwm;
+    bool currentLimitActive;
+    float pasAssistRatio;
+    bool pasPedaling;
+    uint32_t pasPulseCount;
+    uint16_t phaseDuty[3];
+};
 
 class Motor {
 public:
@@ -8,25 +57,91 @@ public:
     float mph;
     bool isCruiseControl;
     float targetMph;
+    float cruiseErrorRmsMph;
+    float cruiseErrorMeanAbsMph;
+    float cruiseErrorMaxMph;
     bool isPASMode;
     int pasLevel;
     float lastBusVoltage;
     float lastPhaseCurrent;
     float lastElectricalPower;
+    float currentSetpointAmps;
+    float dutyCommand;
     float pasCadenceRpm;
+    bool pasBackpedaling;
     float throttleFilteredRatio;
+    bool brakeActive;
+    float throttleVoltage;
+    DriveSource driveSource;
+    float currentRequestAmps;
+    int drivePwm;
+    bool currentLimitActive;
+    float pasAssistRatio;
+    bool pasPedaling;
+    bool isCalibrating;       // A learning routine owns the bridge; control updates stand down
+    volatile bool currentSenseCalRequested;
+    volatile bool faultClearRequested;
+    volatile bool hallLearnRequested;
+    volatile bool hallRevStartRequested;
+    volatile bool hallRevStopRequested;
+    volatile bool coastRequested;
+    volatile bool brakeRequested;
 
-    static void onHallChange();
     static void onPasPulse();
     void setPASMode(int mode);
+    void sampleInputs();
     void CalculateSpeed();
     static void COAST();
     static void BRAKE();
     void updateCruiseControl();
     void updatePASControl();
     void updateThrottleControl();
-    
-    
+    void calibrateCurrentSense();
+    /** Ask the control task to run calibrateCurrentSense at its next idle cycle. */
+    void requestCurrentSenseCalibration() { currentSenseCalRequested = true; }
+    void updateCurrentSenseCalibration();
+    /** Ask the control task to clear the DRV8353 fault and release the nFAULT trip. */
+    void requestFaultClear() { faultClearRequested = true; }
+    /** Arm the brake trip for the regen setting, report trips and handle fault clears. */
+    void updateFaultTrip();
+    /** Step the rotor through every sector at low current and learn the hall -> sector table. */
+    void learnHalls();
+    /** Start counting hall edges while the wheel is turned one revolution by hand. */
+    void startHallRevolutionCount();
+    /** Finish the hand-turned revolution and store edges per revolution. */
+    void finishHallRevolutionCount();
+    /** Ask the control task to run learnHalls at its next cycle. */
+    void requestHallLearn() { hallLearnRequested = true; }
+    /** Ask the control task to start the hand-turned revolution count. */
+    void requestHallRevolutionStart() { hallRevStartRequested = true; }
+    /** Ask the control task to finish the hand-turned revolution count. */
+    void requestHallRevolutionStop() { hallRevStopRequested = true; }
+    /** Run any requested hall learning step; control task only. */
+    void updateHallLearning();
+    /** Ask the control task to coast the bridge at its next cycle. */
+    void requestCoast() { coastRequested = true; }
+    /** Ask the control task to brake the bridge at its next cycle. */
+    void requestBrake() { brakeRequested = true; }
+    /** Rider mode changes from other tasks; applied by applyRequests. */
+    void requestCruiseControl(bool enable) { cruiseRequest.post(enable); }
+    void requestCruiseTarget(float mph) { cruiseTargetRequest.post(mph); }
+    void requestPASMode(bool enable) { pasModeRequest.post(enable); }
+    void requestPASLevel(int level) { pasLevelRequest.post(level); }
+    /** Take posted MOTOR commands; control task only, at the loop boundary. */
+    void applyRequests();
+    /** Publish this cycle's state; control task only, once per loop. */
+    void publishState();
+    /** Coherent copy of the last published state; safe from any task. */
+    MotorState state() const { return published.read(); }
+    /** Sample the published state into telemetry; telemetry task only, at its own rate. */
+    void reportState() const;
+
+private:
+    Seqlock<MotorState> published;
+    Mailbox<bool> cruiseRequest;
+    Mailbox<float> cruiseTargetRequest;
+    Mailbox<bool> pasModeRequest;
+    Mailbox<int> pasLevelRequest;
 };
 
 #endif
\ No newline at end of file
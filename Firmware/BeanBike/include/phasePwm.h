@@ -0,0 +1,47 @@
+#ifndef PHASE_PWM_H
+#define PHASE_PWM_H
+
+#include <stdint.h>
+
+/** What, if anything, has the MCPWM trip zone forced the outputs off for. */
+enum class PwmTrip : uint8_t {
+    None,
+    DriverFault, // nFAULT, latched until cleared
+    Brake,       // Brake lever, released cycle by cycle with the lever
+    Deadline     // Forced by the control deadline monitor, latched until it recovers
+};
+
+// Three-phase gate drive on MCPWM unit 0: one timer per phase, center-aligned, complementary
+// INHx/INLx pairs with hardware dead time. The DRV8353 runs in 6x PWM mode behind it.
+class PhasePwm {
+public:
+    static constexpr uint16_t DUTY_FULL = 0xFFFF; // Duty scale used by the control code
+
+    /** Route the six gate pins to MCPWM, sync the phase timers and start with every phase off. */
+    void init();
+    /** Latch all three duties together; they take effect at the next period boundary. */
+    void setDuties(uint16_t dutyA, uint16_t dutyB, uint16_t dutyC);
+    /** Duty last latched for a phase, on the DUTY_FULL scale. */
+    uint16_t duty(int phase) const { return duties[phase]; }
+    /** Drive (true) or float (false, both FETs off) each phase. */
+    void setPhaseEnables(bool a, bool b, bool c);
+    /** Let the brake lever trip the outputs in hardware; disarm only while regen drives the bridge. */
+    void armBrakeTrip(bool armed);
+    /** Current trip zone state; the trip itself happens in hardware, this only reports it. */
+    PwmTrip trip() const;
+    /** Release a latched nFAULT trip; fails while nFAULT is still asserted. */
+    bool clearDriverFaultTrip();
+    /** Latch the outputs off from software through the same one-shot trip as nFAULT; any task. */
+    void forceDeadlineTrip();
+    /** Release a deadline trip; fails, leaving the latch, while nFAULT is asserted. */
+    bool clearDeadlineTrip();
+
+private:
+    bool brakeTripArmed = false;
+    volatile bool deadlineTripped = false;
+    uint32_t peakTicks = 0;      // Counter peak of the up/down timers; compare range is 0..peak
+    uint8_t floatingMask = 0x07; // Bit per phase currently held Hi-Z
+    uint16_t duties[3] = {0, 0, 0};
+};
+
+#endif
@@ -2,6 +2,10 @@
 #define PINS_H
 
 #include <stdint.h>
+#ifdef ARDUINO
+#include <Arduino.h>
+#endif
+#include "fastGpio.h"
 
 struct PinDef {
     const char* name;
@@ -12,27 +16,44 @@ struct PinDef {
 class Pins {
 public:
     // Pins
-    static const PinDef BATT_LEVEL;
-    static const PinDef MOTOR_ENABLE;
-    static const PinDef MOTOR_INHA;
-    static const PinDef MOTOR_INLA;
-    static const PinDef MOTOR_INHB;  
-    static const PinDef MOTOR_INLB;
-    static const PinDef MOTOR_INHC;
-    static const PinDef MOTOR_INLC;
-    static const PinDef MOTOR_SOA;
-    static const PinDef MOTOR_SOB;
-    static const PinDef MOTOR_SOC;
-    static const PinDef MOTOR_HALL_A;
-    static const PinDef MOTOR_HALL_B;
-    static const PinDef MOTOR_HALL_C;
-    static const PinDef MOTOR_FAULT;
-    static const PinDef SENSOR_THROTTLE_DATA;
-    static const PinDef SENSOR_PAS_PULSE;
-    static const PinDef SENSOR_BRAKE_SIGNAL;
+    // Analog inputs must be ADC1 pins (GPIO32-39): only ADC1 runs under DMA (see adc.cpp)
+    static constexpr PinDef BATT_LEVEL = {"BATT_LEVEL", 36, INPUT};
+    static constexpr PinDef MOTOR_ENABLE = {"MOTOR_ENABLE", 13, OUTPUT};
+    static constexpr PinDef MOTOR_INHA = {"MOTOR_INHA", 12, OUTPUT};
+    static constexpr PinDef MOTOR_INLA = {"MOTOR_INLA", 14, OUTPUT};
+    static constexpr PinDef MOTOR_INHB = {"MOTOR_INHB", 27, OUTPUT};
+    static constexpr PinDef MOTOR_INLB = {"MOTOR_INLB", 26, OUTPUT};
+    static constexpr PinDef MOTOR_INHC = {"MOTOR_INHC", 25, OUTPUT};
+    static constexpr PinDef MOTOR_INLC = {"MOTOR_INLC", 22, OUTPUT};
+    static constexpr PinDef MOTOR_SOA = {"MOTOR_SOA", 32, INPUT};
+    static constexpr PinDef MOTOR_SOB = {"MOTOR_SOB", 33, INPUT};
+    static constexpr PinDef MOTOR_SOC = {"MOTOR_SOC", 35, INPUT};
+    // Phase voltage dividers for back-EMF sensing; not fitted on this board revision (-1)
+    static constexpr PinDef MOTOR_VSENSE_A = {"MOTOR_VSENSE_A", -1, INPUT};
+    static constexpr PinDef MOTOR_VSENSE_B = {"MOTOR_VSENSE_B", -1, INPUT};
+    static constexpr PinDef MOTOR_VSENSE_C = {"MOTOR_VSENSE_C", -1, INPUT};
+    static constexpr PinDef MOTOR_HALL_A = {"MOTOR_HALL_A", 9, INPUT};
+    static constexpr PinDef MOTOR_HALL_B = {"MOTOR_HALL_B", 10, INPUT};
+    static constexpr PinDef MOTOR_HALL_C = {"MOTOR_HALL_C", 11, INPUT};
+    static constexpr PinDef MOTOR_FAULT = {"MOTOR_FAULT", 15, INPUT};
+    static constexpr PinDef SENSOR_THROTTLE_DATA = {"SENSOR_THROTTLE_DATA", 34, INPUT};
+    static constexpr PinDef SENSOR_PAS_PULSE = {"SENSOR_PAS_PULSE", 17, INPUT};
+    static constexpr PinDef SENSOR_PAS_DIR = {"SENSOR_PAS_DIR", 39, INPUT};
+    static constexpr PinDef SENSOR_BRAKE_SIGNAL = {"SENSOR_BRAKE_SIGNAL", 16, INPUT_PULLUP};
+    // DRV8353 SPI; configured by the SPI master driver, not initPins
+    static constexpr PinDef DRV_SPI_SCLK = {"DRV_SPI_SCLK", 18, OUTPUT};
+    static constexpr PinDef DRV_SPI_MISO = {"DRV_SPI_MISO", 19, INPUT};
+    static constexpr PinDef DRV_SPI_MOSI = {"DRV_SPI_MOSI", 23, OUTPUT};
+    static constexpr PinDef DRV_SPI_CS = {"DRV_SPI_CS", 5, OUTPUT};
 
     // Functions
     void initPins();
 };
 
-#endif
\ No newline at end of file
+// Inputs read on the control path and in ISRs, by direct register access
+typedef FastPinGroup<Pins::MOTOR_HALL_A.pin, Pins::MOTOR_HALL_B.pin, Pins::MOTOR_HALL_C.pin> HallInputs;  // A=bit0
+typedef FastPin<Pins::SENSOR_BRAKE_SIGNAL.pin> BrakeInput;   // Active low
+typedef FastPin<Pins::SENSOR_PAS_DIR.pin> PasDirInput;
+typedef FastPin<Pins::MOTOR_FAULT.pin> FaultInput;           // nFAULT, active low
+
+#endif
@@ -0,0 +1,25 @@
+#ifndef PULSE_COUNTER_H
+#define PULSE_COUNTER_H
+
+#include <stdint.h>
+
+class PulseCounter {
+public:
+    static constexpr int16_t COUNT_LIMIT = 30000; // Hardware counters wrap to zero at +/- this value
+
+    /** Route the hall and PAS inputs to the PCNT units with glitch filtering and start counting. */
+    void init();
+    /** Fold the hardware counters into the running totals; call from the control task only. */
+    void poll();
+    /** Total hall edges (all three sensors, both edges) since init. */
+    uint32_t hallEdges() const { return hallEdgeTotal; }
+    /** Net PAS pulses since init; counts down while backpedaling on quadrature sensors. */
+    int32_t pasPulses() const { return pasPulseTotal; }
+
+private:
+    uint32_t hallEdgeTotal = 0;
+    int32_t pasPulseTotal = 0;
+    int16_t lastRaw[3] = {0, 0, 0};
+};
+
+#endif
@@ -0,0 +1,40 @@
+#ifndef TASK_MONITOR_H
+#define TASK_MONITOR_H
+
+#include <stdint.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+enum class TaskId : uint8_t {
+    Control,
+    AdcAcquire,
+    UartReceive,
+    Telemetry,
+    Battery,
+    Count
+};
+
+class TaskMonitor {
+public:
+    static constexpr int TASK_COUNT = static_cast<int>(TaskId::Count);
+
+    void registerTask(TaskId id, const char* name, TaskHandle_t handle);
+    /** Mark the start of a task's active work; each task only touches its own slot. */
+    void beginWork(TaskId id);
+    void endWork(TaskId id);
+    /** Send each task's load over the last window and its minimum free stack. */
+    void report();
+
+private:
+    struct TaskSlot {
+        const char* name;
+        TaskHandle_t handle;
+        volatile uint32_t busyMicros;
+        uint32_t workStartMicros;
+        uint32_t reportedBusyMicros;
+    };
+    TaskSlot slots[TASK_COUNT] = {};
+    uint32_t windowStartMicros = 0;
+};
+
+#endif
@@ -0,0 +1,50 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <atomic>
+#include <stdint.h>
+#include "SpscQueue.h"
+
+struct TelemetryRecord {
+    static constexpr int NAME_LENGTH = 32;
+    static constexpr int VALUE_LENGTH = 48;
+    char name[NAME_LENGTH];
+    char value[VALUE_LENGTH];
+};
+
+// Control-task telemetry: posted into a lock-free queue, coalesced to the latest value per
+// name on core 0 and printed at whatever rate the serial link sustains. Continuous values are
+// not posted per cycle; the telemetry task samples the published MotorState instead.
+class Telemetry {
+public:
+    static constexpr int QUEUE_DEPTH = 128;
+    static constexpr int MAX_NAMES = 128;
+
+    /** Queue a value from the control task; never blocks, counts a drop when the queue is full. */
+    void post(const char* name, const char* value);
+    /** Record a value sampled on the telemetry task itself; printed only when it changed. */
+    void sample(const char* name, const char* value);
+    void sample(const char* name, float value, int decimals = 2);
+    void sample(const char* name, long value);
+    void sample(const char* name, unsigned long value);
+    /** Drain the queue and print the next changed value; false when there was nothing to print. */
+    bool service();
+    uint32_t dropped() const { return droppedCount.load(std::memory_order_relaxed); }
+
+private:
+    struct Entry {
+        uint32_t hash;
+        bool pending;
+        TelemetryRecord record;
+    };
+
+    SpscQueue<TelemetryRecord, QUEUE_DEPTH> queue;
+    std::atomic<uint32_t> droppedCount{0};
+    Entry entries[MAX_NAMES];
+    int entryCount = 0;
+    int cursor = 0;
+
+    void store(const TelemetryRecord& record, bool onlyIfChanged);
+};
+
+#endif
@@ -0,0 +1,72 @@
+# PlatformIO post-link check: fail the build if an interrupt handler, a function it calls,
+# or data it reads has landed in flash. Flash-resident code stalls on a cache miss and
+# cannot run at all while NVS or OTA is writing flash.
+import os
+import re
+import subprocess
+
+Import("env")
+
+IRAM_RANGE = (0x40080000, 0x400A0000)
+DRAM_RANGE = (0x3FFAE000, 0x40000000)
+
+# Keep in step with the IRAM_ATTR / DRAM_ATTR markings in src/
+REQUIRED_IRAM = [
+    "Motor::onPasPulse()",
+    "DRV8353::checkFault()",
+    "makeFrame(bool, unsigned char, unsigned short)",
+    "DrvSpi::submitFromIsr(unsigned short, void (*)(unsigned short, void*), void*)",
+    "PIController::update(float, float, float)",
+    "PhasePwm::setDuties(unsigned short, unsigned short, unsigned short)",
+    "readPhaseCurrentAmps(int)",
+    "readAveragePhaseCurrentMagnitude()",
+]
+REQUIRED_DRAM = []
+
+MAP_PATH = os.path.join(env.subst("$BUILD_DIR"), "firmware.map")
+env.Append(LINKFLAGS=["-Wl,-Map," + MAP_PATH])
+
+SYMBOL_LINE = re.compile(r"^\s+0x([0-9a-fA-F]{8,16})\s+(\S.*)$")
+
+
+def demangle(names):
+    mangled = [name for name in names if name.startswith("_Z")]
+    if not mangled:
+        return {}
+    cxxfilt = env.subst("$CXX").replace("g++", "c++filt")
+    result = subprocess.run([cxxfilt], input="\n".join(mangled), capture_output=True, text=True, check=True)
+    return dict(zip(mangled, result.stdout.splitlines()))
+
+
+def read_symbols(path):
+    addresses = {}
+    with open(path, encoding="utf-8", errors="replace") as map_file:
+        for line in map_file:
+            match = SYMBOL_LINE.match(line)
+            if match and not match.group(2).startswith(("0x", "PROVIDE", ".")):
+                addresses[match.group(2).strip()] = int(match.group(1), 16)
+    names = demangle(list(addresses))
+    return {names.get(name, name): address for name, address in addresses.items()}
+
+
+def check_placement(source, target, env):
+    symbols = read_symbols(MAP_PATH)
+    errors = []
+    for names, (low, high), region in ((REQUIRED_IRAM, IRAM_RANGE, "IRAM"), (REQUIRED_DRAM, DRAM_RANGE, "DRAM")):
+        for name in names:
+            address = symbols.get(name)
+            if address is None:
+                errors.append("%s: not found in %s" % (name, MAP_PATH))
+            elif not low <= address < high:
+                errors.append("%s: at 0x%08x, expected %s" % (name, address, region))
+
+    if errors:
+        print("check_iram: ISR/control-path placement check failed")
+        for error in errors:
+            print("  " + error)
+        return 1
+    print("check_iram: %d IRAM and %d DRAM symbols placed correctly" % (len(REQUIRED_IRAM), len(REQUIRED_DRAM)))
+    return 0
+
+
+env.AddPostAction("$BUILD_DIR/${PROGNAME}.elf", check_placement)
@@ -1,21 +1,16 @@
 #include <Arduino.h>
-#include <SPI.h>
+#include <atomic>
+#include <freertos/semphr.h>
 #include "DRV8353.h"
+#include "drvSpi.h"
+#include "FixedString.h"
 #include "globals.h"
 
-static int csPin = 5;
-static String faultMessage = "";
+static DrvSpi transport;
 
 #pragma DRV8353 SPI
-void beginTransaction() {
-    SPI.beginTransaction(SPISettings(1000000, MSBFIRST, SPI_MODE1));
-}
-
-void endTransaction() {
-    SPI.endTransaction();
-}
 
-uint16_t makeFrame(bool isRead, uint8_t addr, uint16_t data11)
+uint16_t IRAM_ATTR makeFrame(bool isRead, uint8_t addr, uint16_t data11)
 {
     return (static_cast<uint16_t>(isRead) << 15) |
            ((addr & 0x0F) << 11) |
@@ -24,17 +19,7 @@ uint16_t makeFrame(bool isRead, uint8_t addr, uint16_t data11)
 
 uint16_t transferFrame(uint16_t frame)
 {
-    uint8_t hi = frame >> 8;
-    uint8_t lo = frame & 0xFF;
-
-    SPI.beginTransaction(SPISettings(1000000, MSBFIRST, SPI_MODE1));
-    digitalWrite(csPin, LOW);
-    uint8_t respHi = SPI.transfer(hi);
-    uint8_t respLo = SPI.transfer(lo);
-    digitalWrite(csPin, HIGH);
-    SPI.endTransaction();
-
-    return (static_cast<uint16_t>(respHi) << 8) | respLo;
+    return transport.transfer(frame);
 }
 
 uint16_t parseData(uint16_t rxWord)
@@ -55,341 +40,451 @@ void writeRegister(uint8_t addr, uint16_t data11)
 
 #pragma endregion
 
+using namespace DrvRegs;
+
 namespace {
-constexpr uint8_t DRIVER_CONTROL_ADDR = 0x02;
-constexpr uint16_t DRIVER_CTRL_OCP_ACT   = 1u << 10;
-constexpr uint16_t DRIVER_CTRL_DIS_GDUV  = 1u << 9;
-constexpr uint16_t DRIVER_CTRL_DIS_GDF   = 1u << 8;
-constexpr uint16_t DRIVER_CTRL_OTW_REP   = 1u << 7;
-constexpr uint16_t DRIVER_CTRL_PWM_MODE  = 0b11u << 5;
-constexpr uint16_t DRIVER_CTRL_1PWM_COM  = 1u << 4;
-constexpr uint16_t DRIVER_CTRL_1PWM_DIR  = 1u << 3;
-constexpr uint16_t DRIVER_CTRL_COAST     = 1u << 2;
-constexpr uint16_t DRIVER_CTRL_BRAKE     = 1u << 1;
-constexpr uint16_t DRIVER_CTRL_CLR_FLT   = 1u << 0;
-
-constexpr uint8_t GATE_DRIVE_HS_ADDR = 0x03;
-constexpr uint16_t GATE_HS_LOCK_MASK     = 0b111u << 8;
-constexpr uint16_t GATE_HS_IDRIVEP_MASK  = 0x0Fu << 4;
-constexpr uint16_t GATE_HS_IDRIVEN_MASK  = 0x0Fu;
-
-constexpr uint8_t GATE_DRIVE_LS_ADDR = 0x04;
-constexpr uint16_t GATE_LS_CBC_MASK      = 1u << 10;
-constexpr uint16_t GATE_LS_TDRIVE_MASK   = 0b11u << 8;
-constexpr uint16_t GATE_LS_IDRIVEP_MASK  = 0x0Fu << 4;
-constexpr uint16_t GATE_LS_IDRIVEN_MASK  = 0x0Fu;
-
-constexpr uint8_t OCP_CONTROL_ADDR = 0x05;
-constexpr uint16_t OCP_TRETRY_MASK   = 1u << 10;
-constexpr uint16_t OCP_DEADTIME_MASK = 0b11u << 8;
-constexpr uint16_t OCP_MODE_MASK     = 0b11u << 6;
-constexpr uint16_t OCP_DEG_MASK      = 0b11u << 4;
-constexpr uint16_t OCP_VDS_MASK      = 0x0Fu;
-
-constexpr uint8_t CSA_CONTROL_ADDR = 0x06;
-constexpr uint16_t CSA_FET_MASK     = 1u << 10;
-constexpr uint16_t CSA_VREF_DIV_MASK= 1u << 9;
-constexpr uint16_t CSA_LS_REF_MASK  = 1u << 8;
-constexpr uint16_t CSA_GAIN_MASK    = 0b11u << 6;
-constexpr uint16_t CSA_DIS_SEN_MASK = 1u << 5;
-constexpr uint16_t CSA_CAL_A_MASK   = 1u << 4;
-constexpr uint16_t CSA_CAL_B_MASK   = 1u << 3;
-constexpr uint16_t CSA_CAL_C_MASK   = 1u << 2;
-constexpr uint16_t CSA_SEN_LVL_MASK = 0b11u;
-
-constexpr uint8_t DRIVER_CONFIG_ADDR = 0x07;
-constexpr uint16_t DRIVER_CFG_CAL_MODE_MASK = 1u << 0;
-
-uint16_t readRegister11(uint8_t addr) {
-    return readRegister(addr);
+// Shadow of the control registers (0x02-0x07) as this firmware last wrote them. Setters
+// modify the shadow instead of reading the chip back, and the scrubber compares the chip
+// against it to catch registers lost to a brownout or corrupted on the bus.
+constexpr uint8_t FIRST_CONTROL_ADDR = DriverControl::ADDRESS;
+constexpr uint8_t LAST_CONTROL_ADDR = DriverConfig::ADDRESS;
+constexpr int CONTROL_REGISTER_COUNT = LAST_CONTROL_ADDR - FIRST_CONTROL_ADDR + 1;
+// GATE_DRIVE_HS last, so a restored LOCK cannot block repairs to the other registers
+constexpr uint8_t SCRUB_ORDER[CONTROL_REGISTER_COUNT] = {
+    GateDriveLs::ADDRESS, OcpControl::ADDRESS, CsaControl::ADDRESS, DriverConfig::ADDRESS, DriverControl::ADDRESS,
+    GateDriveHs::ADDRESS
+};
+
+uint16_t shadow[CONTROL_REGISTER_COUNT];
+bool shadowSeeded = false;
+portMUX_TYPE shadowLock = portMUX_INITIALIZER_UNLOCKED;
+std::atomic<uint32_t> shadowWrites{0};  // Lets the scrubber discard a check that raced a write
+// Control, UART and battery (scrubber) tasks all write registers. A read-modify-write of the
+// shadow and the SPI frame that carries it must go out as one, or two setters on the same
+// register can each send a word missing the other's field. Recursive: setters nest.
+SemaphoreHandle_t registerMutex = nullptr;
+
+class RegisterLock {
+public:
+    RegisterLock() {
+        if (registerMutex != nullptr) {
+            xSemaphoreTakeRecursive(registerMutex, portMAX_DELAY);
+        }
+    }
+    ~RegisterLock() {
+        if (registerMutex != nullptr) {
+            xSemaphoreGiveRecursive(registerMutex);
+        }
+    }
+};
+
+bool isControlRegister(uint8_t addr) {
+    return addr >= FIRST_CONTROL_ADDR && addr <= LAST_CONTROL_ADDR;
 }
 
-void writeRegister11(uint8_t addr, uint16_t value) {
-    writeRegister(addr, value & 0x07FF);
+uint16_t shadowValue(uint8_t addr) {
+    portENTER_CRITICAL(&shadowLock);
+    const uint16_t value = shadow[addr - FIRST_CONTROL_ADDR];
+    portEXIT_CRITICAL(&shadowLock);
+    return value;
 }
 
-void updateRegisterBit(uint8_t addr, uint16_t mask, bool set) {
-    uint16_t reg = readRegister11(addr);
-    if (set) {
-        reg |= mask;
-    } else {
-        reg &= static_cast<uint16_t>(~mask);
+// CLR_FLT self-clears on the chip, so it is never part of the intended state
+uint16_t compareMask(uint8_t addr) {
+    return addr == DriverControl::ADDRESS ? static_cast<uint16_t>(DATA_MASK & ~DriverControl::ClrFlt::MASK) : DATA_MASK;
+}
+
+void writeRegister11(uint8_t addr, uint16_t value) {
+    RegisterLock lock;
+    value &= DATA_MASK;
+    if (isControlRegister(addr)) {
+        portENTER_CRITICAL(&shadowLock);
+        shadow[addr - FIRST_CONTROL_ADDR] = value & compareMask(addr);
+        portEXIT_CRITICAL(&shadowLock);
+        shadowWrites.fetch_add(1, std::memory_order_relaxed);
     }
-    writeRegister11(addr, reg);
+    writeRegister(addr, value);
 }
 
 void updateRegisterField(uint8_t addr, uint16_t mask, uint16_t value) {
-    uint16_t reg = readRegister11(addr);
+    RegisterLock lock;
+    uint16_t reg = shadowValue(addr);
     reg &= static_cast<uint16_t>(~mask);
     reg |= static_cast<uint16_t>(value & mask);
     writeRegister11(addr, reg);
 }
 
-uint16_t readDriverControlRegister() {
-    return readRegister11(DRIVER_CONTROL_ADDR);
+// Masks and shifts fold to constants: writeFields<CsaControl::CalA, CsaControl::CalB>(x, y)
+// is one read-modify-write of the shadow and one SPI frame
+template <typename... Fields>
+void writeFields(typename Fields::Type... values) {
+    typedef FieldSet<Fields...> Set;
+    updateRegisterField(Set::ADDRESS, Set::MASK, Set::encode(values...));
 }
 
-void writeDriverControlRegister(uint16_t value) {
-    writeRegister11(DRIVER_CONTROL_ADDR, value);
+// True when the shadow already holds `value`, so a setter called every cycle costs no SPI frame
+template <typename F>
+bool shadowHolds(typename F::Type value) {
+    return F::decode(shadowValue(F::ADDRESS)) == value;
 }
+} // namespace
 
-void updateDriverControlBit(uint16_t mask, bool set) {
-    updateRegisterBit(DRIVER_CONTROL_ADDR, mask, set);
+#pragma DRV8353 Fault 
+// Only the SPI transport task decodes faults, so one static buffer is enough
+static FixedString<512> faultText;
+
+static const char* collectFaults(uint8_t address, uint16_t value) {
+    faultText.clear();
+    for (size_t i = 0; i < FIELD_COUNT; ++i) {
+        const FieldInfo& field = FIELD_TABLE[i];
+        if (field.address == address && fieldValue(field, value) != 0) {
+            faultText.appendf("%s=%s\n", field.name, field.description);
+        }
+    }
+    return faultText.c_str();
 }
+#pragma endregion
 
-void updateDriverControlField(uint16_t mask, uint16_t value) {
-    updateRegisterField(DRIVER_CONTROL_ADDR, mask, value);
+#pragma region DRV8353 Scrub
+static uint8_t scrubIndex = 0;
+static uint32_t scrubRepairs = 0;
+static uint32_t scrubReadMismatches = 0;  // Two back-to-back reads disagreed
+static std::atomic<uint8_t> failedRegisters{0};
+static std::atomic<uint8_t> csaGainCode{0};
+
+static bool readControlRegister(uint8_t addr, uint16_t& value) {
+    uint16_t rx = 0;
+    if (!transport.tryTransfer(makeFrame(true, addr, 0x000), rx)) {
+        return false;
+    }
+    value = parseData(rx);
+    return true;
+}
+
+static void seedShadow() {
+    bool seeded = true;
+    for (uint8_t addr = FIRST_CONTROL_ADDR; addr <= LAST_CONTROL_ADDR; ++addr) {
+        uint16_t value = 0;
+        seeded &= readControlRegister(addr, value);
+        portENTER_CRITICAL(&shadowLock);
+        shadow[addr - FIRST_CONTROL_ADDR] = value & compareMask(addr);
+        portEXIT_CRITICAL(&shadowLock);
+    }
+    shadowSeeded = seeded;
+    if (!seeded) {
+        uart.sendData("DRV_SCRUB", "DISABLED");
+    }
 }
-} // namespace
-
-#pragma DRV8353 Fault 
-struct FaultBit {
-    uint8_t bit;
-    const char* label;
-    const char* description;
-};
 
-static constexpr FaultBit fault1Map[] = {
-    {10, "FAULT", "Fault detected"},
-    {9,  "VDS_OCP", "VDS Monitor Overcurrent"},
-    {8,  "GDF", "Gate Drive Fault"},
-    {7,  "UVLO", "Under-voltage lockout"},
-    {6,  "OTSD", "Over-temperature shutdown"},
-    {5,  "VDS_HA", "VDS overcurrent high-side A"},
-    {4,  "VDS_LA", "VDS overcurrent low-side A"},
-    {3,  "VDS_HB", "VDS overcurrent high-side B"},
-    {2,  "VDS_LB", "VDS overcurrent low-side B"},
-    {1,  "VDS_HC", "VDS overcurrent high-side C"},
-    {0,  "VDS_LC", "VDS overcurrent low-side C"},
-};
-static constexpr FaultBit VGSMap[] = {
-    {10, "SA_OC", "Overcurrent On Phase A Amplifier"},
-    {9,  "SB_OC", "Overcurrent On Phase B Amplifier"},
-    {8,  "SC_OC", "Overcurrent On Phase C Amplifier"},
-    {7,  "OTW", "Overtemperature Warning"},
-    {6,  "GDUV", "VCP Charge Pump and/or VGLS Under-voltage"},
-    {5,  "VGS_HA", "Gate Drive Fault A High-Side MOSFET"},
-    {4,  "VGS_LA", "Gate Drive Fault A Low-Side MOSFET"},
-    {3,  "VGS_HB", "Gate Drive Fault B High-Side MOSFET"},
-    {2,  "VGS_LB", "Gate Drive Fault B Low-Side MOSFET"},
-    {1,  "VGS_HC", "Gate Drive Fault C High-Side MOSFET"},
-    {0,  "VGS_LC", "Gate Drive Fault C Low-Side MOSFET"},
-};
+static void markRegister(uint8_t addr, bool failed) {
+    const uint8_t bit = static_cast<uint8_t>(1u << (addr - FIRST_CONTROL_ADDR));
+    if (failed) {
+        failedRegisters.fetch_or(bit);
+    } else {
+        failedRegisters.fetch_and(static_cast<uint8_t>(~bit));
+    }
+}
 
-static String collectFaults(uint16_t value, const FaultBit* table, size_t count) {
-    String out;
-    for (size_t i = 0; i < count; ++i) {
-        if (value & (1u << table[i].bit)) {
-            out += table[i].label;
-            out += "=";
-            out += table[i].description;
-            out += '\n';
+static void scrubRegister(uint8_t addr) {
+    const uint16_t mask = compareMask(addr);
+    const uint32_t writesBefore = shadowWrites.load(std::memory_order_relaxed);
+    uint16_t actual = 0;
+    if (!readControlRegister(addr, actual)) {
+        return; // Counted by the transport
+    }
+    actual &= mask;
+    const uint16_t intended = shadowValue(addr);
+
+    if (actual != intended) {
+        // Confirm before repairing so a single corrupted frame is not mistaken for a lost register
+        uint16_t confirm = 0;
+        if (!readControlRegister(addr, confirm)) {
+            return;
+        }
+        if ((confirm & mask) != actual) {
+            scrubReadMismatches++;
+            return;
+        }
+        {
+            // Holding the lock, no setter can change the intended state between this check and the repair
+            RegisterLock lock;
+            if (shadowWrites.load(std::memory_order_relaxed) != writesBefore) {
+                return; // A setter changed the intended state mid-check; look again next pass
+            }
+            writeRegister(addr, intended);
         }
+        uint16_t repaired = 0;
+        const bool restored = readControlRegister(addr, repaired) && (repaired & mask) == intended;
+        if (restored) {
+            scrubRepairs++;
+            actual = intended;
+            uart.sendData("DRV_SCRUB_REPAIRED", REGISTERS[addr].name);
+        } else {
+            uart.sendData("DRV_SCRUB_FAILED", REGISTERS[addr].name);
+        }
+        markRegister(addr, !restored);
+    } else {
+        markRegister(addr, false);
+    }
+
+    // Current scaling follows the gain the amplifier is really using
+    if (addr == CsaControl::ADDRESS) {
+        csaGainCode.store(static_cast<uint8_t>(CsaControl::Gain::decode(actual)));
+    }
+}
+
+void DRV8353::scrubNextRegister() {
+    if (!shadowSeeded) {
+        return;
+    }
+    scrubRegister(SCRUB_ORDER[scrubIndex]);
+    scrubIndex++;
+    if (scrubIndex < CONTROL_REGISTER_COUNT) {
+        return;
     }
-    return out;
+    scrubIndex = 0;
+    uart.sendData("DRV_HEALTHY", isHealthy() ? "TRUE" : "FALSE");
+    uart.sendData("DRV_SCRUB_REPAIRS", scrubRepairs);
+    uart.sendData("DRV_SPI_ERRORS", transport.errors() + scrubReadMismatches);
+}
+
+bool DRV8353::isHealthy() const {
+    return failedRegisters.load() == 0;
+}
+
+float DRV8353::senseGain() const {
+    return 5.0f * static_cast<float>(1u << csaGainCode.load()); // 00=5, 01=10, 10=20, 11=40 V/V
 }
 #pragma endregion
 
 void DRV8353::init() {
-    SPI.begin();
+    registerMutex = xSemaphoreCreateRecursiveMutex();
+    transport.init();
     digitalWrite(pins.MOTOR_ENABLE.pin, HIGH);
     uart.sendData("DRV8353_INITIALIZE", "TRUE");
+    seedShadow();
     setAutoCalibrationMode(true);
-    setHighSideSourceCurrentCode(0b1011);
-    setHighSideSinkCurrentCode(0b0101);
-    setLowSideSourceCurrentCode(0b1011);
-    setLowSideSinkCurrentCode(0b0101);
-    setPwmMode(PWMMode::ThreePWM);
-    uint16_t csaControl = readRegister(0x06);
-    config.currentSenseGain = 5.0f * (1 << (((csaControl >> 6) & 0x03) > 0 ? ((csaControl >> 6) & 0x03) - 1 : 0));
-}
-void DRV8353::checkFault() {
-    uint16_t regFAULT_STATUS_1 = readRegister(drvRegisters[0].address);
-    
-    bool faultDetected = (regFAULT_STATUS_1 & (1u << 10)) != 0;
+    setHighSideCurrentCodes(0b1011, 0b0101);
+    setLowSideCurrentCodes(0b1011, 0b0101);
+    setPwmMode(PWMMode::SixPWM);  // MCPWM drives INHx/INLx as complementary pairs
+    csaGainCode.store(static_cast<uint8_t>(CsaControl::Gain::decode(shadowValue(CsaControl::ADDRESS))));
+    config.currentSenseGain = senseGain();
+}
+// Fault status is read asynchronously: the nFAULT ISR only queues the frames and the
+// transport task decodes them once the responses arrive
+static void onVgsStatus2(uint16_t response, void* context) {
+    const uint16_t regFAULT_STATUS_1 = static_cast<uint16_t>(reinterpret_cast<uintptr_t>(context));
+    const uint16_t regVGS_STATUS_2 = parseData(response);
+    uart.sendData("FAULT_STATUS", "TRUE");
+    uart.sendData("FAULT1", collectFaults(FaultStatus1::ADDRESS, regFAULT_STATUS_1));
+    uart.sendData("FAULT2", collectFaults(VgsStatus2::ADDRESS, regVGS_STATUS_2));
+}
+
+static void onFaultStatus1(uint16_t response, void* context) {
+    const uint16_t regFAULT_STATUS_1 = parseData(response);
+    bool faultDetected = FaultStatus1::Fault::decode(regFAULT_STATUS_1);
 
     if (faultDetected) {
-        uint16_t regVGS_STATUS_2 = readRegister(drvRegisters[1].address);
-        uart.sendData("FAULT_STATUS", "TRUE");
-        uart.sendData("FAULT1", collectFaults(regFAULT_STATUS_1, fault1Map, sizeof(fault1Map)/sizeof(fault1Map[0])));
-        uart.sendData("FAULT2", collectFaults(regVGS_STATUS_2, VGSMap, sizeof(VGSMap)/sizeof(VGSMap[0])));
+        transport.submit(makeFrame(true, VgsStatus2::ADDRESS, 0x000), onVgsStatus2,
+                         reinterpret_cast<void*>(static_cast<uintptr_t>(regFAULT_STATUS_1)));
     } else {
         uart.sendData("FAULT_STATUS", "FALSE");
     }
 }
+
+// nFAULT ISR: IRAM-resident, and the address is a literal so nothing is read from flash
+void IRAM_ATTR DRV8353::checkFault() {
+    transport.submitFromIsr(makeFrame(true, FaultStatus1::ADDRESS, 0x000), onFaultStatus1, nullptr);
+}
 void DRV8353::send3PWMMotorSignal(uint16_t pwmA, uint16_t pwmB, uint16_t pwmC) {
-    analogWrite(pins.MOTOR_INHA.pin, pwmA);
-    analogWrite(pins.MOTOR_INHB.pin, pwmB);
-    analogWrite(pins.MOTOR_INHC.pin, pwmC);
-    uart.sendData("MOTOR_PWM", "A:" + String(pwmA) + " B:" + String(pwmB) + " C:" + String(pwmC));
+    phasePwm.setDuties(pwmA, pwmB, pwmC);  // Reported from the published MotorState, not per call
+}
+void DRV8353::setPhaseEnables(bool a, bool b, bool c) {
+    phasePwm.setPhaseEnables(a, b, c);
 }
 #pragma region DRV8353ControlFunctions
 void DRV8353::clearFault() {
-    uint16_t driverControl = readDriverControlRegister();
-    writeDriverControlRegister(driverControl | DRIVER_CTRL_CLR_FLT);
+    RegisterLock lock;
+    writeRegister11(DriverControl::ADDRESS, shadowValue(DriverControl::ADDRESS) | DriverControl::ClrFlt::MASK);
     uart.sendData("CLEAR_FAULT", "TRUE");
 }
 void DRV8353::setOcpActionAllBridges(bool enable) {
-    updateDriverControlBit(DRIVER_CTRL_OCP_ACT, enable);
+    writeFields<DriverControl::OcpAct>(enable);
     uart.sendData("DRV_OCP_ACT", enable ? "TRUE" : "FALSE");
 }
 void DRV8353::enableChargePumpUvFault(bool enable) {
-    updateDriverControlBit(DRIVER_CTRL_DIS_GDUV, !enable);
+    writeFields<DriverControl::DisGduv>(!enable);
     uart.sendData("DRV_GDUV_FAULT", enable ? "TRUE" : "FALSE");
 }
 void DRV8353::enableGateDriveFault(bool enable) {
-    updateDriverControlBit(DRIVER_CTRL_DIS_GDF, !enable);
+    writeFields<DriverControl::DisGdf>(!enable);
     uart.sendData("DRV_GDF_FAULT", enable ? "TRUE" : "FALSE");
 }
 void DRV8353::enableOtwReporting(bool enable) {
-    updateDriverControlBit(DRIVER_CTRL_OTW_REP, enable);
+    writeFields<DriverControl::OtwRep>(enable);
     uart.sendData("DRV_OTW_REPORT", enable ? "TRUE" : "FALSE");
 }
 void DRV8353::setPwmMode(PWMMode mode) {
-    uint16_t field = static_cast<uint16_t>(mode) << 5;
-    updateDriverControlField(DRIVER_CTRL_PWM_MODE, field);
-    switch (mode) {
-        case PWMMode::SixPWM: uart.sendData("DRV_PWM_MODE", "6PWM"); break;
-        case PWMMode::ThreePWM: uart.sendData("DRV_PWM_MODE", "3PWM"); break;
-        case PWMMode::OnePWM: uart.sendData("DRV_PWM_MODE", "1PWM"); break;
-        case PWMMode::IndependentPWM: uart.sendData("DRV_PWM_MODE", "INDEPENDENT"); break;
-    }
+    writeFields<DriverControl::PwmMode>(mode);
+    uart.sendData("DRV_PWM_MODE", PWM_MODE_NAMES[static_cast<uint8_t>(mode)]);
 }
 void DRV8353::setOnePwmComAsync(bool enable) {
-    updateDriverControlBit(DRIVER_CTRL_1PWM_COM, enable);
+    writeFields<DriverControl::OnePwmCom>(enable);
     uart.sendData("DRV_1PWM_COM", enable ? "TRUE" : "FALSE");
 }
 void DRV8353::setOnePwmDirHigh(bool enable) {
-    updateDriverControlBit(DRIVER_CTRL_1PWM_DIR, enable);
+    writeFields<DriverControl::OnePwmDir>(enable);
     uart.sendData("DRV_1PWM_DIR", enable ? "TRUE" : "FALSE");
 }
 void DRV8353::setCoast(bool enable) {
-    updateDriverControlBit(DRIVER_CTRL_COAST, enable);
+    if (shadowSeeded && shadowHolds<DriverControl::Coast>(enable)) {
+        return;  // The scrubber restores the bit if the chip lost it
+    }
+    writeFields<DriverControl::Coast>(enable);
     uart.sendData("MOTOR_MODE", enable ? "COAST" : "RUN");
 }
 void DRV8353::setBrake(bool enable) {
-    updateDriverControlBit(DRIVER_CTRL_BRAKE, enable);
+    if (shadowSeeded && shadowHolds<DriverControl::Brake>(enable)) {
+        return;
+    }
+    writeFields<DriverControl::Brake>(enable);
     uart.sendData("MOTOR_MODE", enable ? "BRAKE" : "RUN");
 }
 
 void DRV8353::lockGateDriveRegisters(bool lock) {
-    uint16_t field = static_cast<uint16_t>((lock ? 0b110u : 0b011u) << 8);
-    updateRegisterField(GATE_DRIVE_HS_ADDR, GATE_HS_LOCK_MASK, field);
+    writeFields<GateDriveHs::Lock>(lock ? LockCode::Lock : LockCode::Unlock);
     uart.sendData("DRV_LOCK", lock ? "TRUE" : "FALSE");
 }
 
 void DRV8353::setHighSideSourceCurrentCode(uint8_t code) {
-    code &= 0x0F;
-    updateRegisterField(GATE_DRIVE_HS_ADDR, GATE_HS_IDRIVEP_MASK, static_cast<uint16_t>(code) << 4);
-    uart.sendData("DRV_HS_IDRIVEP", String(code));
+    code &= GateDriveHs::IdriveP::MAX;
+    writeFields<GateDriveHs::IdriveP>(code);
+    uart.sendData("DRV_HS_IDRIVEP", code);
 }
 
 void DRV8353::setHighSideSinkCurrentCode(uint8_t code) {
-    code &= 0x0F;
-    updateRegisterField(GATE_DRIVE_HS_ADDR, GATE_HS_IDRIVEN_MASK, static_cast<uint16_t>(code));
-    uart.sendData("DRV_HS_IDRIVEN", String(code));
+    code &= GateDriveHs::IdriveN::MAX;
+    writeFields<GateDriveHs::IdriveN>(code);
+    uart.sendData("DRV_HS_IDRIVEN", code);
+}
+
+void DRV8353::setHighSideCurrentCodes(uint8_t sourceCode, uint8_t sinkCode) {
+    sourceCode &= GateDriveHs::IdriveP::MAX;
+    sinkCode &= GateDriveHs::IdriveN::MAX;
+    writeFields<GateDriveHs::IdriveP, GateDriveHs::IdriveN>(sourceCode, sinkCode);
+    uart.sendData("DRV_HS_IDRIVEP", sourceCode);
+    uart.sendData("DRV_HS_IDRIVEN", sinkCode);
 }
 
 void DRV8353::setCbcClearingByPwm(bool enabled) {
-    updateRegisterBit(GATE_DRIVE_LS_ADDR, GATE_LS_CBC_MASK, enabled);
+    writeFields<GateDriveLs::CbcClear>(enabled);
     uart.sendData("DRV_LS_CBC", enabled ? "TRUE" : "FALSE");
 }
 
 void DRV8353::setLowSideTdriveCode(uint8_t code) {
-    code &= 0x03;
-    updateRegisterField(GATE_DRIVE_LS_ADDR, GATE_LS_TDRIVE_MASK, static_cast<uint16_t>(code) << 8);
-    uart.sendData("DRV_LS_TDRIVE", String(code));
+    code &= GateDriveLs::Tdrive::MAX;
+    writeFields<GateDriveLs::Tdrive>(code);
+    uart.sendData("DRV_LS_TDRIVE", code);
 }
 
 void DRV8353::setLowSideSourceCurrentCode(uint8_t code) {
-    code &= 0x0F;
-    updateRegisterField(GATE_DRIVE_LS_ADDR, GATE_LS_IDRIVEP_MASK, static_cast<uint16_t>(code) << 4);
-    uart.sendData("DRV_LS_IDRIVEP", String(code));
+    code &= GateDriveLs::IdriveP::MAX;
+    writeFields<GateDriveLs::IdriveP>(code);
+    uart.sendData("DRV_LS_IDRIVEP", code);
 }
 
 void DRV8353::setLowSideSinkCurrentCode(uint8_t code) {
-    code &= 0x0F;
-    updateRegisterField(GATE_DRIVE_LS_ADDR, GATE_LS_IDRIVEN_MASK, static_cast<uint16_t>(code));
-    uart.sendData("DRV_LS_IDRIVEN", String(code));
+    code &= GateDriveLs::IdriveN::MAX;
+    writeFields<GateDriveLs::IdriveN>(code);
+    uart.sendData("DRV_LS_IDRIVEN", code);
+}
+
+void DRV8353::setLowSideCurrentCodes(uint8_t sourceCode, uint8_t sinkCode) {
+    sourceCode &= GateDriveLs::IdriveP::MAX;
+    sinkCode &= GateDriveLs::IdriveN::MAX;
+    writeFields<GateDriveLs::IdriveP, GateDriveLs::IdriveN>(sourceCode, sinkCode);
+    uart.sendData("DRV_LS_IDRIVEP", sourceCode);
+    uart.sendData("DRV_LS_IDRIVEN", sinkCode);
 }
 
 void DRV8353::setRetryTime(RetryTime retryTime) {
-    updateRegisterBit(OCP_CONTROL_ADDR, OCP_TRETRY_MASK, retryTime == RetryTime::Retry50us);
+    writeFields<OcpControl::Tretry>(retryTime);
     uart.sendData("DRV_OCP_RETRY", retryTime == RetryTime::Retry50us ? "50US" : "8MS");
 }
 
 void DRV8353::setDeadTime(DeadTime deadTime) {
-    uint16_t field = static_cast<uint16_t>(deadTime) << 8;
-    updateRegisterField(OCP_CONTROL_ADDR, OCP_DEADTIME_MASK, field);
-    uart.sendData("DRV_DEADTIME", String(static_cast<uint8_t>(deadTime)));
+    writeFields<OcpControl::DeadTimeSel>(deadTime);
+    uart.sendData("DRV_DEADTIME", static_cast<uint8_t>(deadTime));
 }
 
 void DRV8353::setOcpMode(OcpMode mode) {
-    uint16_t field = static_cast<uint16_t>(mode) << 6;
-    updateRegisterField(OCP_CONTROL_ADDR, OCP_MODE_MASK, field);
-    uart.sendData("DRV_OCP_MODE", String(static_cast<uint8_t>(mode)));
+    writeFields<OcpControl::Mode>(mode);
+    uart.sendData("DRV_OCP_MODE", static_cast<uint8_t>(mode));
 }
 
 void DRV8353::setOcpDeglitch(OcpDeglitch deglitch) {
-    uint16_t field = static_cast<uint16_t>(deglitch) << 4;
-    updateRegisterField(OCP_CONTROL_ADDR, OCP_DEG_MASK, field);
-    uart.sendData("DRV_OCP_DEG", String(static_cast<uint8_t>(deglitch)));
+    writeFields<OcpControl::Deglitch>(deglitch);
+    uart.sendData("DRV_OCP_DEG", static_cast<uint8_t>(deglitch));
 }
 
 void DRV8353::setVdsLevelCode(uint8_t code) {
-    code &= 0x0F;
-    updateRegisterField(OCP_CONTROL_ADDR, OCP_VDS_MASK, static_cast<uint16_t>(code));
-    uart.sendData("DRV_VDS_LVL", String(code));
+    code &= OcpControl::VdsLevel::MAX;
+    writeFields<OcpControl::VdsLevel>(code);
+    uart.sendData("DRV_VDS_LVL", code);
 }
 
 void DRV8353::selectCsaFetSense(bool useShx) {
-    updateRegisterBit(CSA_CONTROL_ADDR, CSA_FET_MASK, useShx);
+    writeFields<CsaControl::CsaFet>(useShx);
     uart.sendData("DRV_CSA_FET", useShx ? "SHX" : "SPX");
 }
 
 void DRV8353::setSenseReferenceDivideBy2(bool enable) {
-    updateRegisterBit(CSA_CONTROL_ADDR, CSA_VREF_DIV_MASK, enable);
+    writeFields<CsaControl::VrefDiv>(enable);
     uart.sendData("DRV_CSA_VREF", enable ? "DIV2" : "FULL");
 }
 
 void DRV8353::setLowSideReferenceToShx(bool enable) {
-    updateRegisterBit(CSA_CONTROL_ADDR, CSA_LS_REF_MASK, enable);
+    writeFields<CsaControl::LsRef>(enable);
     uart.sendData("DRV_CSA_LSREF", enable ? "SHX" : "SPX");
 }
 
 void DRV8353::setCsaGain(CsaGain gain) {
-    uint16_t field = static_cast<uint16_t>(gain) << 6;
-    updateRegisterField(CSA_CONTROL_ADDR, CSA_GAIN_MASK, field);
-    uart.sendData("DRV_CSA_GAIN", String(static_cast<uint8_t>(gain)));
+    writeFields<CsaControl::Gain>(gain);
+    uart.sendData("DRV_CSA_GAIN", static_cast<uint8_t>(gain));
 }
 
 void DRV8353::enableSenseOcp(bool enable) {
-    updateRegisterBit(CSA_CONTROL_ADDR, CSA_DIS_SEN_MASK, !enable);
+    writeFields<CsaControl::DisSen>(!enable);
     uart.sendData("DRV_CSA_OCP", enable ? "TRUE" : "FALSE");
 }
 
 void DRV8353::calibrateSenseAmpA(bool enable) {
-    updateRegisterBit(CSA_CONTROL_ADDR, CSA_CAL_A_MASK, enable);
+    writeFields<CsaControl::CalA>(enable);
     uart.sendData("DRV_CSA_CAL_A", enable ? "TRUE" : "FALSE");
 }
 
 void DRV8353::calibrateSenseAmpB(bool enable) {
-    updateRegisterBit(CSA_CONTROL_ADDR, CSA_CAL_B_MASK, enable);
+    writeFields<CsaControl::CalB>(enable);
     uart.sendData("DRV_CSA_CAL_B", enable ? "TRUE" : "FALSE");
 }
 
 void DRV8353::calibrateSenseAmpC(bool enable) {
-    updateRegisterBit(CSA_CONTROL_ADDR, CSA_CAL_C_MASK, enable);
+    writeFields<CsaControl::CalC>(enable);
     uart.sendData("DRV_CSA_CAL_C", enable ? "TRUE" : "FALSE");
 }
 
+void DRV8353::calibrateSenseAmps(bool enable) {
+    writeFields<CsaControl::CalA, CsaControl::CalB, CsaControl::CalC>(enable, enable, enable);
+    uart.sendData("DRV_CSA_CAL", enable ? "TRUE" : "FALSE");
+}
+
 void DRV8353::setSenseOcpThreshold(SenseOcpLevel level) {
-    updateRegisterField(CSA_CONTROL_ADDR, CSA_SEN_LVL_MASK, static_cast<uint16_t>(level));
-    uart.sendData("DRV_CSA_SENLVL", String(static_cast<uint8_t>(level)));
+    writeFields<CsaControl::SenLevel>(level);
+    uart.sendData("DRV_CSA_SENLVL", static_cast<uint8_t>(level));
 }
 
 void DRV8353::setAutoCalibrationMode(bool enable) {
-    updateRegisterBit(DRIVER_CONFIG_ADDR, DRIVER_CFG_CAL_MODE_MASK, enable);
+    writeFields<DriverConfig::CalMode>(enable);
     uart.sendData("DRV_CAL_MODE", enable ? "AUTO" : "MANUAL");
 }
 #pragma endregion
@@ -0,0 +1,110 @@
+#include <stdio.h>
+#include "drvRegisterMap.h"
+
+// No Arduino dependencies: the host decoder in tools/drvdecode links this file as well.
+
+namespace DrvRegs {
+
+const char* const PWM_MODE_NAMES[] = {"6PWM", "3PWM", "1PWM", "INDEPENDENT"};
+
+namespace {
+const char* const LOCK_NAMES[] = {nullptr, nullptr, nullptr, "UNLOCK", nullptr, nullptr, "LOCK", nullptr};
+const char* const RETRY_NAMES[] = {"8MS", "50US"};
+const char* const DEADTIME_NAMES[] = {"50NS", "100NS", "200NS", "400NS"};
+const char* const OCP_MODE_NAMES[] = {"LATCHED", "AUTO_RETRY", "REPORT_ONLY", "DISABLED"};
+const char* const DEGLITCH_NAMES[] = {"1US", "2US", "4US", "8US"};
+const char* const GAIN_NAMES[] = {"5V/V", "10V/V", "20V/V", "40V/V"};
+const char* const SEN_LVL_NAMES[] = {"0.25V", "0.5V", "0.75V", "1V"};
+}
+
+const FieldInfo FIELD_TABLE[] = {
+    describe<FaultStatus1::Fault>("FAULT", "Fault detected"),
+    describe<FaultStatus1::VdsOcp>("VDS_OCP", "VDS Monitor Overcurrent"),
+    describe<FaultStatus1::Gdf>("GDF", "Gate Drive Fault"),
+    describe<FaultStatus1::Uvlo>("UVLO", "Under-voltage lockout"),
+    describe<FaultStatus1::Otsd>("OTSD", "Over-temperature shutdown"),
+    describe<FaultStatus1::VdsHa>("VDS_HA", "VDS overcurrent high-side A"),
+    describe<FaultStatus1::VdsLa>("VDS_LA", "VDS overcurrent low-side A"),
+    describe<FaultStatus1::VdsHb>("VDS_HB", "VDS overcurrent high-side B"),
+    describe<FaultStatus1::VdsLb>("VDS_LB", "VDS overcurrent low-side B"),
+    describe<FaultStatus1::VdsHc>("VDS_HC", "VDS overcurrent high-side C"),
+    describe<FaultStatus1::VdsLc>("VDS_LC", "VDS overcurrent low-side C"),
+
+    describe<VgsStatus2::SaOc>("SA_OC", "Overcurrent On Phase A Amplifier"),
+    describe<VgsStatus2::SbOc>("SB_OC", "Overcurrent On Phase B Amplifier"),
+    describe<VgsStatus2::ScOc>("SC_OC", "Overcurrent On Phase C Amplifier"),
+    describe<VgsStatus2::Otw>("OTW", "Overtemperature Warning"),
+    describe<VgsStatus2::Gduv>("GDUV", "VCP Charge Pump and/or VGLS Under-voltage"),
+    describe<VgsStatus2::VgsHa>("VGS_HA", "Gate Drive Fault A High-Side MOSFET"),
+    describe<VgsStatus2::VgsLa>("VGS_LA", "Gate Drive Fault A Low-Side MOSFET"),
+    describe<VgsStatus2::VgsHb>("VGS_HB", "Gate Drive Fault B High-Side MOSFET"),
+    describe<VgsStatus2::VgsLb>("VGS_LB", "Gate Drive Fault B Low-Side MOSFET"),
+    describe<VgsStatus2::VgsHc>("VGS_HC", "Gate Drive Fault C High-Side MOSFET"),
+    describe<VgsStatus2::VgsLc>("VGS_LC", "Gate Drive Fault C Low-Side MOSFET"),
+
+    describe<DriverControl::OcpAct>("OCP_ACT", "OCP shuts down all half-bridges"),
+    describe<DriverControl::DisGduv>("DIS_GDUV", "VCP/VGLS undervoltage fault disabled"),
+    describe<DriverControl::DisGdf>("DIS_GDF", "Gate drive fault disabled"),
+    describe<DriverControl::OtwRep>("OTW_REP", "OTW reported on nFAULT"),
+    describe<DriverControl::PwmMode>("PWM_MODE", "PWM input mode", PWM_MODE_NAMES),
+    describe<DriverControl::OnePwmCom>("1PWM_COM", "1x PWM asynchronous rectification"),
+    describe<DriverControl::OnePwmDir>("1PWM_DIR", "1x PWM direction"),
+    describe<DriverControl::Coast>("COAST", "All MOSFETs Hi-Z"),
+    describe<DriverControl::Brake>("BRAKE", "All low-side MOSFETs on"),
+    describe<DriverControl::ClrFlt>("CLR_FLT", "Clear latched faults"),
+
+    describe<GateDriveHs::Lock>("LOCK", "Register lock", LOCK_NAMES),
+    describe<GateDriveHs::IdriveP>("IDRIVEP_HS", "High-side source current code"),
+    describe<GateDriveHs::IdriveN>("IDRIVEN_HS", "High-side sink current code"),
+
+    describe<GateDriveLs::CbcClear>("CBC", "Cycle-by-cycle fault cleared on PWM edge"),
+    describe<GateDriveLs::Tdrive>("TDRIVE", "Peak gate-current drive time code"),
+    describe<GateDriveLs::IdriveP>("IDRIVEP_LS", "Low-side source current code"),
+    describe<GateDriveLs::IdriveN>("IDRIVEN_LS", "Low-side sink current code"),
+
+    describe<OcpControl::Tretry>("TRETRY", "OCP retry time", RETRY_NAMES),
+    describe<OcpControl::DeadTimeSel>("DEAD_TIME", "Gate driver dead time", DEADTIME_NAMES),
+    describe<OcpControl::Mode>("OCP_MODE", "OCP response", OCP_MODE_NAMES),
+    describe<OcpControl::Deglitch>("OCP_DEG", "OCP deglitch time", DEGLITCH_NAMES),
+    describe<OcpControl::VdsLevel>("VDS_LVL", "VDS overcurrent threshold code"),
+
+    describe<CsaControl::CsaFet>("CSA_FET", "CSA positive input is SHx"),
+    describe<CsaControl::VrefDiv>("VREF_DIV", "CSA reference is VREF/2"),
+    describe<CsaControl::LsRef>("LS_REF", "Low-side VDS measured SHx-SNx"),
+    describe<CsaControl::Gain>("CSA_GAIN", "Sense amplifier gain", GAIN_NAMES),
+    describe<CsaControl::DisSen>("DIS_SEN", "Sense overcurrent fault disabled"),
+    describe<CsaControl::CalA>("CSA_CAL_A", "Amplifier A inputs shorted"),
+    describe<CsaControl::CalB>("CSA_CAL_B", "Amplifier B inputs shorted"),
+    describe<CsaControl::CalC>("CSA_CAL_C", "Amplifier C inputs shorted"),
+    describe<CsaControl::SenLevel>("SEN_LVL", "Sense overcurrent threshold", SEN_LVL_NAMES),
+
+    describe<DriverConfig::CalMode>("CAL_MODE", "Automatic amplifier calibration"),
+};
+const size_t FIELD_COUNT = sizeof(FIELD_TABLE) / sizeof(FIELD_TABLE[0]);
+
+size_t formatRegister(uint8_t address, uint16_t reg, char* out, size_t size) {
+    if (size == 0) {
+        return 0;
+    }
+    out[0] = '\0';
+    size_t used = 0;
+    for (size_t i = 0; i < FIELD_COUNT && used + 1 < size; ++i) {
+        const FieldInfo& field = FIELD_TABLE[i];
+        if (field.address != address) {
+            continue;
+        }
+        const uint16_t value = fieldValue(field, reg);
+        const char* separator = used == 0 ? "" : " ";
+        const char* valueName = field.valueNames ? field.valueNames[value] : nullptr;
+        const int written = valueName
+            ? snprintf(out + used, size - used, "%s%s=%s", separator, field.name, valueName)
+            : snprintf(out + used, size - used, "%s%s=%u", separator, field.name, static_cast<unsigned>(value));
+        if (written < 0) {
+            break;
+        }
+        used = used + written < size ? used + written : size - 1;
+    }
+    return used;
+}
+
+} // namespace DrvRegs
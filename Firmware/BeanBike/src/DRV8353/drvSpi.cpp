@@ -0,0 +1,161 @@
+#include <Arduino.h>
+#include <esp_attr.h>
+#include <atomic>
+#include "drvSpi.h"
+#include "globals.h"
+
+constexpr spi_host_device_t DRV_SPI_HOST = SPI3_HOST;   // VSPI
+constexpr int DRV_SPI_MODE = 1;                        // CPOL 0, CPHA 1
+constexpr int DRV_FRAME_BITS = 16;
+constexpr uint32_t DRV_SPI_TIMEOUT_MS = 20;
+constexpr uint32_t DRV_SPI_TASK_STACK = 3072;
+constexpr UBaseType_t DRV_SPI_TASK_PRIORITY = configMAX_PRIORITIES - 3;
+constexpr BaseType_t DRV_SPI_TASK_CORE = 0;
+
+// Word-aligned DMA buffers, one pair per frame in flight; touched only by the transport task
+static DMA_ATTR uint8_t txBuffers[DrvSpi::BATCH_SIZE][4];
+static DMA_ATTR uint8_t rxBuffers[DrvSpi::BATCH_SIZE][4];
+static spi_transaction_t transactions[DrvSpi::BATCH_SIZE];
+
+static std::atomic<uint16_t> nextSequence{1};
+
+bool DrvSpi::init() {
+    spi_bus_config_t bus = {};
+    bus.mosi_io_num = Pins::DRV_SPI_MOSI.pin;
+    bus.miso_io_num = Pins::DRV_SPI_MISO.pin;
+    bus.sclk_io_num = Pins::DRV_SPI_SCLK.pin;
+    bus.quadwp_io_num = -1;
+    bus.quadhd_io_num = -1;
+    bus.max_transfer_sz = 4;
+
+    spi_device_interface_config_t dev = {};
+    dev.mode = DRV_SPI_MODE;
+    dev.clock_speed_hz = static_cast<int>(config.drvSpiClockHz);
+    dev.spics_io_num = Pins::DRV_SPI_CS.pin;
+    dev.queue_size = BATCH_SIZE;
+    dev.cs_ena_pretrans = 1; // nSCS setup time before the first SCLK edge
+
+    requests = xQueueCreate(QUEUE_DEPTH, sizeof(Request));
+    if (requests == nullptr ||
+        spi_bus_initialize(DRV_SPI_HOST, &bus, SPI_DMA_CH_AUTO) != ESP_OK ||
+        spi_bus_add_device(DRV_SPI_HOST, &dev, &device) != ESP_OK) {
+        uart.sendData("DRV_SPI", "INIT_FAILED");
+        return false;
+    }
+
+    xTaskCreatePinnedToCore(transportTask, "DRV_SPI", DRV_SPI_TASK_STACK, this, DRV_SPI_TASK_PRIORITY, nullptr, DRV_SPI_TASK_CORE);
+    uart.sendData("DRV_SPI_CLOCK_HZ", config.drvSpiClockHz);
+    return true;
+}
+
+bool DrvSpi::submit(uint16_t frame, DrvSpiCallback callback, void* context) {
+    if (requests == nullptr) {
+        errorCount++;
+        return false;
+    }
+    const Request request = {frame, 0, callback, context, nullptr};
+    if (xQueueSend(requests, &request, 0) != pdTRUE) {
+        errorCount++;
+        return false;
+    }
+    return true;
+}
+
+bool IRAM_ATTR DrvSpi::submitFromIsr(uint16_t frame, DrvSpiCallback callback, void* context) {
+    if (requests == nullptr) {
+        return false;
+    }
+    const Request request = {frame, 0, callback, context, nullptr};
+    BaseType_t woken = pdFALSE;
+    const bool queued = xQueueSendFromISR(requests, &request, &woken) == pdTRUE;
+    if (woken == pdTRUE) {
+        portYIELD_FROM_ISR();
+    }
+    return queued;
+}
+
+uint16_t DrvSpi::transfer(uint16_t frame) {
+    uint16_t response = 0;
+    tryTransfer(frame, response);
+    return response;
+}
+
+bool DrvSpi::tryTransfer(uint16_t frame, uint16_t& response) {
+    response = 0;
+    const uint16_t sequence = nextSequence.fetch_add(1, std::memory_order_relaxed);
+    const Request request = {frame, sequence, nullptr, nullptr, xTaskGetCurrentTaskHandle()};
+    const TickType_t timeout = pdMS_TO_TICKS(DRV_SPI_TIMEOUT_MS);
+    if (requests == nullptr || xQueueSend(requests, &request, timeout) != pdTRUE) {
+        errorCount++;
+        return false;
+    }
+
+    // The notification value is (sequence << 16) | response; a late answer to an earlier
+    // timed-out transfer carries a different sequence and is skipped
+    const TickType_t start = xTaskGetTickCount();
+    while (true) {
+        const TickType_t elapsed = xTaskGetTickCount() - start;
+        uint32_t value = 0;
+        if (elapsed >= timeout || xTaskNotifyWait(0, UINT32_MAX, &value, timeout - elapsed) != pdTRUE) {
+            errorCount++;
+            return false;
+        }
+        if ((value >> 16) == sequence) {
+            response = static_cast<uint16_t>(value & 0xFFFF);
+            return true;
+        }
+    }
+}
+
+void DrvSpi::runBatch(Request* batch, int count) {
+    // Queue the whole batch first so the frames go out back to back under DMA
+    int inFlight = 0;
+    for (int i = 0; i < count; ++i) {
+        txBuffers[i][0] = static_cast<uint8_t>(batch[i].frame >> 8);
+        txBuffers[i][1] = static_cast<uint8_t>(batch[i].frame & 0xFF);
+        transactions[i] = {};
+        transactions[i].length = DRV_FRAME_BITS;
+        transactions[i].rxlength = DRV_FRAME_BITS;
+        transactions[i].tx_buffer = txBuffers[i];
+        transactions[i].rx_buffer = rxBuffers[i];
+        transactions[i].user = &batch[i];  // Results are matched by transaction, never by order
+        if (spi_device_queue_trans(device, &transactions[i], portMAX_DELAY) == ESP_OK) {
+            inFlight++;
+        } else {
+            // A waiter times out on its own; a callback is dropped rather than fed garbage
+            errorCount++;
+        }
+    }
+
+    for (int i = 0; i < inFlight; ++i) {
+        spi_transaction_t* done = nullptr;
+        if (spi_device_get_trans_result(device, &done, portMAX_DELAY) != ESP_OK || done == nullptr) {
+            errorCount++;
+            continue;
+        }
+        const Request& request = *static_cast<const Request*>(done->user);
+        const uint8_t* rx = static_cast<const uint8_t*>(done->rx_buffer);
+        const uint16_t response = static_cast<uint16_t>((rx[0] << 8) | rx[1]);
+
+        if (request.waiter != nullptr) {
+            xTaskNotify(request.waiter, (static_cast<uint32_t>(request.sequence) << 16) | response, eSetValueWithOverwrite);
+        } else if (request.callback != nullptr) {
+            request.callback(response, request.context);
+        }
+    }
+}
+
+void DrvSpi::transportTask(void* parameter) {
+    DrvSpi* self = static_cast<DrvSpi*>(parameter);
+    Request batch[BATCH_SIZE];
+    while (true) {
+        if (xQueueReceive(self->requests, &batch[0], portMAX_DELAY) != pdTRUE) {
+            continue;
+        }
+        int count = 1;
+        while (count < BATCH_SIZE && xQueueReceive(self->requests, &batch[count], 0) == pdTRUE) {
+            count++;
+        }
+        self->runBatch(batch, count);
+    }
+}
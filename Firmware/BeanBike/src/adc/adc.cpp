@@ -0,0 +1,191 @@
+#include <Arduino.h>
+#include <esp_adc_cal.h>
+#include <driver/adc.h>
+#include "adc.h"
+#include "adcTable.h"
+#include "globals.h"
+
+constexpr uint32_t ADC_DEFAULT_VREF_MV = 1100; // Used only when the chip has no eFuse calibration
+constexpr uint32_t ADC_FRAME_BYTES = 128;      // 64 conversions per DMA frame
+constexpr uint32_t ADC_DMA_BUFFER_BYTES = 1024;
+constexpr uint32_t ADC_READ_TIMEOUT_MS = 100;
+constexpr int ADC1_CHANNEL_COUNT = 8;
+
+static const PinDef* const CHANNEL_PINS[Adc::CHANNEL_COUNT] = {
+    &Pins::SENSOR_THROTTLE_DATA,
+    &Pins::BATT_LEVEL,
+    &Pins::MOTOR_SOA,
+    &Pins::MOTOR_SOB,
+    &Pins::MOTOR_SOC,
+    &Pins::MOTOR_VSENSE_A,
+    &Pins::MOTOR_VSENSE_B,
+    &Pins::MOTOR_VSENSE_C,
+};
+
+// Channels the current loop and battery limits cannot run without; the phase voltage
+// channels only feed sensorless commutation, which checks for itself
+static const bool CHANNEL_REQUIRED[Adc::CHANNEL_COUNT] = {
+    true, true, true, true, true, false, false, false,
+};
+
+// A required input wired to an ADC2 or digital-only pin would leave ready() false forever and
+// the motor silently off, so a board change that does that fails the build instead
+constexpr bool isAdc1Pin(const PinDef& pin) {
+    return pin.pin >= 32 && pin.pin <= 39;
+}
+static_assert(isAdc1Pin(Pins::SENSOR_THROTTLE_DATA), "throttle input must be an ADC1 pin");
+static_assert(isAdc1Pin(Pins::BATT_LEVEL), "battery input must be an ADC1 pin");
+static_assert(isAdc1Pin(Pins::MOTOR_SOA) && isAdc1Pin(Pins::MOTOR_SOB) && isAdc1Pin(Pins::MOTOR_SOC),
+              "current-sense inputs must be ADC1 pins");
+
+// Precomputed count->millivolt table so conversion is a single lookup on the hot path
+static uint16_t countToMillivolts[Adc::TABLE_SIZE];
+
+// Acquisition state, owned by the ADC task
+static int8_t hardwareToLogical[ADC1_CHANNEL_COUNT];
+static uint8_t frameBuffer[ADC_FRAME_BYTES];
+static uint32_t frameLength = 0;
+static float filteredVolts[Adc::CHANNEL_COUNT];
+static bool filterPrimed[Adc::CHANNEL_COUNT];
+static uint32_t frameSequence = 0;
+
+static const char* calibrationSourceName(esp_adc_cal_value_t source) {
+    switch (source) {
+        case ESP_ADC_CAL_VAL_EFUSE_TP: return "EFUSE_TP";
+        case ESP_ADC_CAL_VAL_EFUSE_VREF: return "EFUSE_VREF";
+        default: return "DEFAULT_VREF";
+    }
+}
+
+static void buildCalibrationTable() {
+    esp_adc_cal_characteristics_t characteristics;
+    const esp_adc_cal_value_t source = esp_adc_cal_characterize(
+        ADC_UNIT_1, ADC_ATTEN_DB_11, ADC_WIDTH_BIT_12, ADC_DEFAULT_VREF_MV, &characteristics);
+
+    buildCountTable(countToMillivolts, Adc::TABLE_SIZE, [&characteristics](uint32_t raw) {
+        return esp_adc_cal_raw_to_voltage(raw, &characteristics);
+    });
+
+    uart.sendData("ADC_CAL_SOURCE", calibrationSourceName(source));
+}
+
+void Adc::init() {
+    buildCalibrationTable();
+
+    // Only ADC1 can be driven by the DMA controller on the ESP32
+    adc_digi_pattern_config_t pattern[CHANNEL_COUNT];
+    uint32_t patternCount = 0;
+    uint32_t channelMask = 0;
+    bool missingRequired = false;
+    for (int i = 0; i < ADC1_CHANNEL_COUNT; ++i) {
+        hardwareToLogical[i] = -1;
+    }
+    for (int i = 0; i < CHANNEL_COUNT; ++i) {
+        const int pin = CHANNEL_PINS[i]->pin;
+        const int8_t hardwareChannel = pin < 0 ? -1 : digitalPinToAnalogChannel(pin);
+        if (hardwareChannel < 0 || hardwareChannel >= ADC1_CHANNEL_COUNT) {
+            uart.sendData("ADC_CHANNEL_UNSUPPORTED", CHANNEL_PINS[i]->name);
+            missingRequired |= CHANNEL_REQUIRED[i];
+            continue;
+        }
+        hardwareToLogical[hardwareChannel] = static_cast<int8_t>(i);
+        channelMask |= 1u << hardwareChannel;
+        pattern[patternCount].atten = ADC_ATTEN_DB_11;
+        pattern[patternCount].channel = static_cast<uint8_t>(hardwareChannel);
+        pattern[patternCount].unit = 0;
+        pattern[patternCount].bit_width = SOC_ADC_DIGI_MAX_BITWIDTH;
+        patternCount++;
+    }
+
+    if (patternCount == 0) {
+        uart.sendData("ADC_DMA_ACTIVE", "FALSE");
+        return;
+    }
+
+    adc_digi_init_config_t initConfig = {};
+    initConfig.max_store_buf_size = ADC_DMA_BUFFER_BYTES;
+    initConfig.conv_num_each_intr = ADC_FRAME_BYTES;
+    initConfig.adc1_chan_mask = channelMask;
+    initConfig.adc2_chan_mask = 0;
+
+    adc_digi_configuration_t digitalConfig = {};
+    digitalConfig.conv_limit_en = true;
+    digitalConfig.conv_limit_num = 250;
+    digitalConfig.pattern_num = patternCount;
+    digitalConfig.adc_pattern = pattern;
+    digitalConfig.sample_freq_hz = config.adcSampleRateHz;
+    digitalConfig.conv_mode = ADC_CONV_SINGLE_UNIT_1;
+    digitalConfig.format = ADC_DIGI_OUTPUT_FORMAT_TYPE1;
+
+    if (adc_digi_initialize(&initConfig) != ESP_OK ||
+        adc_digi_controller_configure(&digitalConfig) != ESP_OK ||
+        adc_digi_start() != ESP_OK) {
+        uart.sendData("ADC_DMA_ACTIVE", "FALSE");
+        return;
+    }
+    uart.sendData("ADC_DMA_ACTIVE", "TRUE");
+
+    // An unsampled channel reads 0 V forever: 0 A of phase current would wind the current loop
+    // to full duty, so the bridge stays off instead
+    requiredChannelsReady = !missingRequired;
+    if (missingRequired) {
+        uart.sendData("ADC_REQUIRED_CHANNEL_MISSING", "TRUE");
+    }
+}
+
+bool Adc::readFrame() {
+    frameLength = 0;
+    return adc_digi_read_bytes(frameBuffer, ADC_FRAME_BYTES, &frameLength, ADC_READ_TIMEOUT_MS) == ESP_OK;
+}
+
+void Adc::publishFrame() {
+    const uint32_t length = frameLength;
+
+    // Average every conversion of a channel in the frame, then apply the per-channel EMA
+    uint32_t millivoltSums[CHANNEL_COUNT] = {};
+    uint16_t sampleCounts[CHANNEL_COUNT] = {};
+    for (uint32_t offset = 0; offset + sizeof(adc_digi_output_data_t) <= length; offset += sizeof(adc_digi_output_data_t)) {
+        const adc_digi_output_data_t* sample = reinterpret_cast<const adc_digi_output_data_t*>(&frameBuffer[offset]);
+        const uint8_t hardwareChannel = sample->type1.channel;
+        if (hardwareChannel >= ADC1_CHANNEL_COUNT || hardwareToLogical[hardwareChannel] < 0) {
+            continue;
+        }
+        const int8_t channel = hardwareToLogical[hardwareChannel];
+        millivoltSums[channel] += countToMillivolts[sample->type1.data];
+        sampleCounts[channel]++;
+    }
+
+    const int batteryChannel = static_cast<int>(AdcChannel::Battery);
+    battery.accumulate(millivoltSums[batteryChannel], sampleCounts[batteryChannel]);
+
+    for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+        if (sampleCounts[channel] == 0) {
+            continue;
+        }
+        const float frameVolts = (static_cast<float>(millivoltSums[channel]) / sampleCounts[channel]) * 0.001f;
+        if (!filterPrimed[channel]) {
+            filteredVolts[channel] = frameVolts;
+            filterPrimed[channel] = true;
+        } else {
+            const float alpha = constrain(config.adcFilterAlpha[channel], 0.0f, 1.0f);
+            filteredVolts[channel] += alpha * (frameVolts - filteredVolts[channel]);
+        }
+    }
+
+    // Readers on the other core retry if they overlap this write, so a frame never tears
+    AdcSnapshot next;
+    for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+        next.volts[channel] = filteredVolts[channel];
+    }
+    next.sequence = ++frameSequence;
+    next.timestampMicros = micros();
+    published.write(next);
+}
+
+AdcSnapshot Adc::snapshot() const {
+    return published.read();
+}
+
+float Adc::readVolts(AdcChannel channel) const {
+    return published.read().volts[static_cast<int>(channel)];
+}
@@ -2,12 +2,42 @@
 #include "battery.h"
 #include "globals.h"
 
-float Battery::getBatteryVoltage() {
-    const float rawVoltage = analogRead(Pins::BATT_LEVEL.pin);
+// Decimation state, owned by the ADC task
+static uint32_t decimationMillivoltSum = 0;
+static uint32_t decimationSampleCount = 0;
+static uint32_t tickSampleCount = 0;
+static int decimationTicks = 0;
+
+// Every battery conversion of the DMA stream is summed (oversampling); one voltage is published
+// per batteryDecimationFactor ticks of batteryOversampleCount conversions (boxcar decimation)
+void Battery::accumulate(uint32_t millivoltSum, uint32_t sampleCount) {
+    if (sampleCount == 0) {
+        return;
+    }
+    decimationMillivoltSum += millivoltSum;
+    decimationSampleCount += sampleCount;
+    tickSampleCount += sampleCount;
+
+    const uint32_t oversample = static_cast<uint32_t>(max(config.batteryOversampleCount, 1));
+    while (tickSampleCount >= oversample) {
+        tickSampleCount -= oversample;
+        decimationTicks++;
+    }
+    if (decimationTicks < max(config.batteryDecimationFactor, 1)) {
+        return;
+    }
+
+    const float pinVoltage = (static_cast<float>(decimationMillivoltSum) / static_cast<float>(decimationSampleCount)) * 0.001f;
+    voltage = pinVoltage * config.batteryVoltageDividerRatio;
 
-    const float batteryVoltage = (rawVoltage / 4095.0f) * config.adcReferenceVoltage * config.batteryVoltageDividerRatio;
-    voltage = batteryVoltage;
-    return batteryVoltage;
+    decimationMillivoltSum = 0;
+    decimationSampleCount = 0;
+    tickSampleCount = 0;
+    decimationTicks = 0;
+}
+
+float Battery::getBatteryVoltage() {
+    return voltage;
 }
 
 float Battery::getBatteryLevel() {
@@ -23,6 +53,5 @@ float Battery::getBatteryLevel() {
 }
     
 void Battery::updateBatteryStatus() {
-    voltage = getBatteryVoltage();
     level = getBatteryLevel();
 }
@@ -1,6 +1,17 @@
 #include <Arduino.h>
 #include "UART.h"
 #include "globals.h"
+#include "ThrottleShaper.h"
+#include "FixedString.h"
+
+constexpr size_t DIRECT_LINE_LENGTH = 128;
+
+// READ replies: Print formats straight into the serial buffer, the same text String(value) gave
+template <typename T>
+static void sendValue(T value) {
+    Serial.print("VALUE ");
+    Serial.println(value);
+}
 
 static bool tokenize(const String& line, String& cmd, String& item, String& arg) {
     int firstSpace = line.indexOf(' ');
@@ -29,152 +40,553 @@ void ParseCommand(String command) {
     }
 
     if (cmd == "SET") {
+        Config& staged = configStore.beginEdit();
         if (item == "CONFIG_WHEEL_DIAMETER_INCHES" && arg.length()) {
-            config.wheelDiameterInches = arg.toInt();
+            staged.wheelDiameterInches = arg.toInt();
             Serial.println("OK SET");
         } 
         else if (item == "CONFIG_PAS_PULSES_PER_REV" && arg.length()) {
-            config.pasPulsesPerRev = arg.toInt();
+            staged.pasPulsesPerRev = arg.toInt();
             Serial.println("OK SET");
         }
         else if (item == "CONFIG_MAX_MOTOR_WATTAGE" && arg.length()) {
-            config.maxMotorWattage = arg.toInt();
+            staged.maxMotorWattage = arg.toInt();
             Serial.println("OK SET");
         } 
         else if (item == "CONFIG_MAX_MOTOR_RPM" && arg.length()) {
-            config.maxMotorRPM = arg.toFloat();
+            staged.maxMotorRPM = arg.toFloat();
             Serial.println("OK SET");
         } 
-        else if (item == "CONFIG_ADC_RESOLUTION_BITS" && arg.length()) {
-            config.adcResolutionBits = arg.toInt();
+        else if (item == "CONFIG_ADC_FILTER_ALPHA_THROTTLE" && arg.length()) {
+            staged.adcFilterAlpha[static_cast<int>(AdcChannel::Throttle)] = arg.toFloat();
             Serial.println("OK SET");
-        } 
-        else if (item == "CONFIG_ADC_REFERENCE_VOLTAGE" && arg.length()) {
-            config.adcReferenceVoltage = arg.toFloat();
+        }
+        else if (item == "CONFIG_ADC_FILTER_ALPHA_BATTERY" && arg.length()) {
+            staged.adcFilterAlpha[static_cast<int>(AdcChannel::Battery)] = arg.toFloat();
             Serial.println("OK SET");
-        } 
+        }
+        else if (item == "CONFIG_ADC_FILTER_ALPHA_CURRENT" && arg.length()) {
+            const float alpha = arg.toFloat();
+            staged.adcFilterAlpha[static_cast<int>(AdcChannel::SenseA)] = alpha;
+            staged.adcFilterAlpha[static_cast<int>(AdcChannel::SenseB)] = alpha;
+            staged.adcFilterAlpha[static_cast<int>(AdcChannel::SenseC)] = alpha;
+            Serial.println("OK SET");
+        }
         else if (item == "CONFIG_CURRENT_SENSE_OFFSET_VOLT" && arg.length()) {
-            config.currentSenseOffsetVolt = arg.toFloat();
+            const float offset = arg.toFloat();
+            for (int phase = 0; phase < 3; ++phase) {
+                staged.currentSenseOffsetVolt[phase] = offset;
+            }
             Serial.println("OK SET");
         } 
+        else if (item == "CONFIG_CURRENT_SENSE_CAL_SAMPLES" && arg.length()) {
+            staged.currentSenseCalSamples = arg.toInt();
+            Serial.println("OK SET");
+        }
+        else if (item == "CONFIG_CURRENT_SENSE_RECAL_INTERVAL_MS" && arg.length()) {
+            staged.currentSenseRecalIntervalMs = arg.toInt();
+            Serial.println("OK SET");
+        }
         else if (item == "CONFIG_BATTERY_VOLTAGE_DIVIDER_RATIO" && arg.length()) {
-            config.batteryVoltageDividerRatio = arg.toFloat();
+            staged.batteryVoltageDividerRatio = arg.toFloat();
             Serial.println("OK SET");
         } 
+        else if (item == "CONFIG_BATTERY_OVERSAMPLE_COUNT" && arg.length()) {
+            staged.batteryOversampleCount = arg.toInt();
+            Serial.println("OK SET");
+        }
+        else if (item == "CONFIG_BATTERY_DECIMATION_FACTOR" && arg.length()) {
+            staged.batteryDecimationFactor = arg.toInt();
+            Serial.println("OK SET");
+        }
         else if (item == "CONFIG_THROTTLE_MIN_VOLTAGE" && arg.length()) {
-            config.throttleMinVoltage = arg.toFloat();
+            staged.throttleMinVoltage = arg.toFloat();
             Serial.println("OK SET");
         } 
         else if (item == "CONFIG_THROTTLE_MAX_VOLTAGE" && arg.length()) {
-            config.throttleMaxVoltage = arg.toFloat();
+            staged.throttleMaxVoltage = arg.toFloat();
             Serial.println("OK SET");
         } 
         else if (item == "CONFIG_THROTTLE_DEADBAND" && arg.length()) {
-            config.throttleDeadband = arg.toFloat();
+            staged.throttleDeadband = arg.toFloat();
             Serial.println("OK SET");
         } 
-        else if (item == "CONFIG_THROTTLE_FILTER_ALPHA" && arg.length()) {
-            config.throttleFilterAlpha = arg.toFloat();
+        else if (item == "CONFIG_THROTTLE_PROFILE" && arg.length()) {
+            if (ThrottleShaper::applyProfile(arg.c_str(), staged)) {
+                Serial.println("OK SET");
+            } else {
+                Serial.println("ERR SET");
+            }
+        }
+        else if (item == "CONFIG_THROTTLE_CUTOFF_HZ" && arg.length()) {
+            staged.throttleCutoffHz = arg.toFloat();
+            Serial.println("OK SET");
+        }
+        else if (item == "CONFIG_THROTTLE_RISE_RATE" && arg.length()) {
+            staged.throttleRiseRatePerSec = arg.toFloat();
+            Serial.println("OK SET");
+        }
+        else if (item == "CONFIG_THROTTLE_FALL_RATE" && arg.length()) {
+            staged.throttleFallRatePerSec = arg.toFloat();
+            Serial.println("OK SET");
+        }
+        else if (item == "CONFIG_THROTTLE_EXPO" && arg.length()) {
+            staged.throttleExpo = arg.toFloat();
+            Serial.println("OK SET");
+        }
+        else if (item == "CONFIG_MAX_PHASE_CURRENT_AMPS" && arg.length()) {
+            staged.maxPhaseCurrentAmps = arg.toFloat();
+            Serial.println("OK SET");
+        }
+        else if (item == "CONFIG_MAX_BATTERY_CURRENT_AMPS" && arg.length()) {
+            staged.maxBatteryCurrentAmps = arg.toFloat();
+            Serial.println("OK SET");
+        }
+        else if (item == "CONFIG_CURRENT_LOOP_KP" && arg.length()) {
+            staged.currentLoopKp = arg.toFloat();
+            Serial.println("OK SET");
+        }
+        else if (item == "CONFIG_CURRENT_LOOP_KI" && arg.length()) {
+            staged.currentLoopKi = arg.toFloat();
+            Serial.println("OK SET");
+        }
+        else if (item == "CONFIG_CRUISE_SPEED_KP" && arg.length()) {
+            staged.cruiseSpeedKp = arg.toFloat();
+            Serial.println("OK SET");
+        }
+        else if (item == "CONFIG_CRUISE_SPEED_KI" && arg.length()) {
+            staged.cruiseSpeedKi = arg.toFloat();
+            Serial.println("OK SET");
+        }
+        else if (item == "CONFIG_PAS_ASSIST_MAP" && arg.length()) {
+            int level = 0;
+            int point = 0;
+            float value = 0.0f;
+            if (sscanf(arg.c_str(), "%d %d %f", &level, &point, &value) == 3 &&
+                level >= 0 && level < Config::PAS_LEVEL_COUNT &&
+                point >= 0 && point < Config::PAS_CADENCE_POINTS) {
+                staged.pasAssistMap[level][point] = constrain(value, 0.0f, 1.0f);
+                Serial.println("OK SET");
+            } else {
+                Serial.println("ERR SET");
+            }
+        }
+        else if (item == "CONFIG_PAS_CADENCE_BREAKPOINT" && arg.length()) {
+            int point = 0;
+            float cadenceRpm = 0.0f;
+            if (sscanf(arg.c_str(), "%d %f", &point, &cadenceRpm) == 2 &&
+                point >= 0 && point < Config::PAS_CADENCE_POINTS) {
+                staged.pasCadenceBreakpointsRpm[point] = cadenceRpm;
+                Serial.println("OK SET");
+            } else {
+                Serial.println("ERR SET");
+            }
+        }
+        else if (item == "CONFIG_PAS_MIN_CADENCE_RPM" && arg.length()) {
+            staged.pasMinCadenceRpm = arg.toFloat();
+            Serial.println("OK SET");
+        }
+        else if (item == "CONFIG_PAS_QUADRATURE" && arg.length()) {
+            staged.pasQuadrature = (arg == "TRUE");
+            Serial.println("OK SET");
+        }
+        else if (item == "CONFIG_PAS_DIRECTION_INVERTED" && arg.length()) {
+            staged.pasDirectionInverted = (arg == "TRUE");
+            Serial.println("OK SET");
+        }
+        else if (item == "CONFIG_REGEN_ENABLED" && arg.length()) {
+            staged.regenEnabled = (arg == "TRUE");
+            Serial.println("OK SET");
+        }
+        else if (item == "CONFIG_REGEN_BRAKE_AMPS" && arg.length()) {
+            staged.regenBrakeAmps = arg.toFloat();
+            Serial.println("OK SET");
+        }
+        else if (item == "CONFIG_REGEN_THROTTLE_BACK_AMPS" && arg.length()) {
+            staged.regenThrottleBackAmps = arg.toFloat();
+            Serial.println("OK SET");
+        }
+        else if (item == "CONFIG_REGEN_MAX_PHASE_CURRENT_AMPS" && arg.length()) {
+            staged.regenMaxPhaseCurrentAmps = arg.toFloat();
+            Serial.println("OK SET");
+        }
+        else if (item == "CONFIG_REGEN_MAX_BATTERY_AMPS" && arg.length()) {
+            staged.regenMaxBatteryAmps = arg.toFloat();
+            Serial.println("OK SET");
+        }
+        else if (item == "CONFIG_REGEN_VOLTAGE_CEILING" && arg.length()) {
+            staged.regenVoltageCeiling = arg.toFloat();
+            Serial.println("OK SET");
+        }
+        else if (item == "CONFIG_REGEN_VOLTAGE_TAPER" && arg.length()) {
+            staged.regenVoltageTaper = arg.toFloat();
+            Serial.println("OK SET");
+        }
+        else if (item == "CONFIG_REGEN_MIN_RPM" && arg.length()) {
+            staged.regenMinRpm = arg.toFloat();
+            Serial.println("OK SET");
+        }
+        else if (item == "CONFIG_REGEN_BACK_EMF_MARGIN" && arg.length()) {
+            staged.regenBackEmfMargin = arg.toFloat();
+            Serial.println("OK SET");
+        }
+        else if (item == "CONFIG_REGEN_MOTORING_TRIP_AMPS" && arg.length()) {
+            staged.regenMotoringTripAmps = arg.toFloat();
+            Serial.println("OK SET");
+        }
+        else if (item == "CONFIG_COMMUTATION_MODE" && arg.length()) {
+            const int mode = arg == "AUTO" ? 0 : arg == "HALL" ? 1 : arg == "SENSORLESS" ? 2 : -1;
+            if (mode >= 0) {
+                staged.commutationOverride = mode;
+                Serial.println("OK SET");
+            } else {
+                Serial.println("ERR SET");
+            }
+        }
+        else if (item == "CONFIG_HALL_EDGES_PER_REV" && arg.length()) {
+            staged.hallEdgesPerRev = arg.toInt();
+            Serial.println("OK SET");
+        }
+        else if (item == "CONFIG_HALL_FAULT_THRESHOLD" && arg.length()) {
+            staged.hallFaultThreshold = arg.toInt();
+            Serial.println("OK SET");
+        }
+        else if (item == "CONFIG_HALL_RECOVERY_EDGES" && arg.length()) {
+            staged.hallRecoveryEdges = arg.toInt();
+            Serial.println("OK SET");
+        }
+        else if (item == "CONFIG_SENSORLESS_MIN_RPM" && arg.length()) {
+            staged.sensorlessMinRpm = arg.toFloat();
+            Serial.println("OK SET");
+        }
+        else if (item == "CONFIG_SENSORLESS_BLANKING" && arg.length()) {
+            staged.sensorlessBlanking = arg.toFloat();
+            Serial.println("OK SET");
+        }
+        else if (item == "CONFIG_PHASE_VOLTAGE_DIVIDER_RATIO" && arg.length()) {
+            staged.phaseVoltageDividerRatio = arg.toFloat();
+            Serial.println("OK SET");
+        }
+        else if (item == "CONFIG_HALL_LEARN_DUTY" && arg.length()) {
+            staged.hallLearnDuty = arg.toFloat();
+            Serial.println("OK SET");
+        }
+        else if (item == "CONFIG_HALL_LEARN_MAX_AMPS" && arg.length()) {
+            staged.hallLearnMaxAmps = arg.toFloat();
             Serial.println("OK SET");
         }
         else if (item == "MOTOR_IS_CRUISE_CONTROL" && arg.length()) {
-            motor.isCruiseControl = (arg == "TRUE");
+            motor.requestCruiseControl(arg == "TRUE");
             Serial.println("OK SET");
         }
         else if (item == "MOTOR_CRUISE_TARGET_MPH" && arg.length()) {
-            motor.targetMph = arg.toFloat();
+            motor.requestCruiseTarget(arg.toFloat());
             Serial.println("OK SET");
         }
         else if (item == "MOTOR_IS_PAS" && arg.length()) {
-            motor.isPASMode = (arg == "TRUE");
+            motor.requestPASMode(arg == "TRUE");
             Serial.println("OK SET");
         }
         else if (item == "MOTOR_PAS_LEVEL" && arg.length()) {
-            motor.pasLevel = arg.toInt();
+            motor.requestPASLevel(arg.toInt());
             Serial.println("OK SET");
         }
         else {
             Serial.println("ERR SET");
         }
+        configStore.submit();
     } else if (cmd == "READ") {
+        const Config activeConfig = configStore.snapshot();
+        const MotorState state = motor.state();
         if(item == "CONFIG_WHEEL_DIAMETER_INCHES") {
-            Serial.println(String("VALUE ") + config.wheelDiameterInches);
+            sendValue(activeConfig.wheelDiameterInches);
         } 
         else if(item == "CONFIG_PAS_PULSES_PER_REV") {
-            Serial.println(String("VALUE ") + config.pasPulsesPerRev);
+            sendValue(activeConfig.pasPulsesPerRev);
         }
         else if (item == "CONFIG_MAX_MOTOR_WATTAGE") {
-            Serial.println(String("VALUE ") + config.maxMotorWattage);
+            sendValue(activeConfig.maxMotorWattage);
         } 
         else if (item == "CONFIG_MAX_MOTOR_RPM") {
-            Serial.println(String("VALUE ") + config.maxMotorRPM);
-        } 
-        else if (item == "CONFIG_ADC_RESOLUTION_BITS") {
-            Serial.println(String("VALUE ") + config.adcResolutionBits);
-        } 
-        else if (item == "CONFIG_ADC_REFERENCE_VOLTAGE") {
-            Serial.println(String("VALUE ") + config.adcReferenceVoltage);
+            sendValue(activeConfig.maxMotorRPM);
         } 
+        else if (item == "CONFIG_ADC_SAMPLE_RATE_HZ") {
+            sendValue(activeConfig.adcSampleRateHz);
+        }
+        else if (item == "CONFIG_ADC_FILTER_ALPHA_THROTTLE") {
+            sendValue(activeConfig.adcFilterAlpha[static_cast<int>(AdcChannel::Throttle)]);
+        }
+        else if (item == "CONFIG_ADC_FILTER_ALPHA_BATTERY") {
+            sendValue(activeConfig.adcFilterAlpha[static_cast<int>(AdcChannel::Battery)]);
+        }
+        else if (item == "CONFIG_ADC_FILTER_ALPHA_CURRENT") {
+            sendValue(activeConfig.adcFilterAlpha[static_cast<int>(AdcChannel::SenseA)]);
+        }
         else if (item == "CONFIG_SHUNT_RESISTANCE_MOHM") {
-            Serial.println(String("VALUE ") + config.shuntResistanceMilliOhm);
+            sendValue(activeConfig.shuntResistanceMilliOhm);
         } 
         else if (item == "CONFIG_CURRENT_SENSE_GAIN") {
-            Serial.println(String("VALUE ") + config.currentSenseGain);
+            sendValue(activeConfig.currentSenseGain);
         }
         else if (item == "CONFIG_CURRENT_SENSE_OFFSET_VOLT") {
-            Serial.println(String("VALUE ") + config.currentSenseOffsetVolt);
+            // Pre-calibration key; SET writes all three phases, READ gives their mean
+            const float* offsets = activeConfig.currentSenseOffsetVolt;
+            sendValue((offsets[0] + offsets[1] + offsets[2]) / 3.0f);
+        }
+        else if (item == "CONFIG_CURRENT_SENSE_OFFSET_VOLT_A") {
+            sendValue(activeConfig.currentSenseOffsetVolt[0]);
         } 
+        else if (item == "CONFIG_CURRENT_SENSE_OFFSET_VOLT_B") {
+            sendValue(activeConfig.currentSenseOffsetVolt[1]);
+        }
+        else if (item == "CONFIG_CURRENT_SENSE_OFFSET_VOLT_C") {
+            sendValue(activeConfig.currentSenseOffsetVolt[2]);
+        }
+        else if (item == "CONFIG_CURRENT_SENSE_CAL_SAMPLES") {
+            sendValue(activeConfig.currentSenseCalSamples);
+        }
+        else if (item == "CONFIG_CURRENT_SENSE_RECAL_INTERVAL_MS") {
+            sendValue(activeConfig.currentSenseRecalIntervalMs);
+        }
         else if (item == "CONFIG_BATTERY_VOLTAGE_DIVIDER_RATIO") {
-            Serial.println(String("VALUE ") + config.batteryVoltageDividerRatio);
+            sendValue(activeConfig.batteryVoltageDividerRatio);
         } 
+        else if (item == "CONFIG_BATTERY_OVERSAMPLE_COUNT") {
+            sendValue(activeConfig.batteryOversampleCount);
+        }
+        else if (item == "CONFIG_BATTERY_DECIMATION_FACTOR") {
+            sendValue(activeConfig.batteryDecimationFactor);
+        }
+        else if (item == "BATTERY_VOLTAGE") {
+            sendValue(state.busVoltage);
+        }
         else if (item == "CONFIG_THROTTLE_MIN_VOLTAGE") {
-            Serial.println(String("VALUE ") + config.throttleMinVoltage);
+            sendValue(activeConfig.throttleMinVoltage);
         } 
         else if (item == "CONFIG_THROTTLE_MAX_VOLTAGE") {
-            Serial.println(String("VALUE ") + config.throttleMaxVoltage);
+            sendValue(activeConfig.throttleMaxVoltage);
         } 
         else if (item == "CONFIG_THROTTLE_DEADBAND") {
-            Serial.println(String("VALUE ") + config.throttleDeadband);
+            sendValue(activeConfig.throttleDeadband);
         } 
-        else if (item == "CONFIG_THROTTLE_FILTER_ALPHA") {
-            Serial.println(String("VALUE ") + config.throttleFilterAlpha);
+        else if (item == "CONFIG_THROTTLE_PROFILE") {
+            sendValue(ThrottleShaper::PROFILES[constrain(activeConfig.throttleProfile, 0, ThrottleShaper::PROFILE_COUNT - 1)].name);
+        }
+        else if (item == "CONFIG_THROTTLE_CUTOFF_HZ") {
+            sendValue(activeConfig.throttleCutoffHz);
+        }
+        else if (item == "CONFIG_THROTTLE_RISE_RATE") {
+            sendValue(activeConfig.throttleRiseRatePerSec);
+        }
+        else if (item == "CONFIG_THROTTLE_FALL_RATE") {
+            sendValue(activeConfig.throttleFallRatePerSec);
+        }
+        else if (item == "CONFIG_THROTTLE_EXPO") {
+            sendValue(activeConfig.throttleExpo);
+        }
+        else if (item == "CONFIG_MAX_PHASE_CURRENT_AMPS") {
+            sendValue(activeConfig.maxPhaseCurrentAmps);
+        }
+        else if (item == "CONFIG_MAX_BATTERY_CURRENT_AMPS") {
+            sendValue(activeConfig.maxBatteryCurrentAmps);
+        }
+        else if (item == "CONFIG_CURRENT_LOOP_KP") {
+            sendValue(activeConfig.currentLoopKp);
+        }
+        else if (item == "CONFIG_CURRENT_LOOP_KI") {
+            sendValue(activeConfig.currentLoopKi);
+        }
+        else if (item == "CONFIG_CRUISE_SPEED_KP") {
+            sendValue(activeConfig.cruiseSpeedKp);
+        }
+        else if (item == "CONFIG_CRUISE_SPEED_KI") {
+            sendValue(activeConfig.cruiseSpeedKi);
+        }
+        else if (item == "CONFIG_PAS_ASSIST_MAP") {
+            // Rows are levels separated by ';', columns follow the cadence breakpoints
+            FixedString<Config::PAS_LEVEL_COUNT * Config::PAS_CADENCE_POINTS * 8> rows;
+            for (int level = 0; level < Config::PAS_LEVEL_COUNT; ++level) {
+                for (int point = 0; point < Config::PAS_CADENCE_POINTS; ++point) {
+                    rows.appendFloat(activeConfig.pasAssistMap[level][point], 2);
+                    rows.append(point + 1 < Config::PAS_CADENCE_POINTS ? "," : ";");
+                }
+            }
+            sendValue(rows.c_str());
+        }
+        else if (item == "CONFIG_PAS_CADENCE_BREAKPOINTS") {
+            FixedString<Config::PAS_CADENCE_POINTS * 10> points;
+            for (int point = 0; point < Config::PAS_CADENCE_POINTS; ++point) {
+                points.appendFloat(activeConfig.pasCadenceBreakpointsRpm[point], 1);
+                if (point + 1 < Config::PAS_CADENCE_POINTS) {
+                    points.append(",");
+                }
+            }
+            sendValue(points.c_str());
+        }
+        else if (item == "CONFIG_HALL_SECTOR_TABLE") {
+            FixedString<32> table;
+            for (int code = 0; code < 8; ++code) {
+                const uint8_t sector = activeConfig.hallSectorTable[code];
+                table.appendf("%d", sector == Commutation::INVALID_SECTOR ? -1 : sector);
+                if (code < 7) {
+                    table.append(",");
+                }
+            }
+            sendValue(table.c_str());
+        }
+        else if (item == "CONFIG_HALL_DIRECTION") {
+            sendValue((activeConfig.hallSequenceForward ? "FORWARD" : "REVERSE"));
+        }
+        else if (item == "CONFIG_PAS_MIN_CADENCE_RPM") {
+            sendValue(activeConfig.pasMinCadenceRpm);
+        }
+        else if (item == "PAS_CADENCE_RPM") {
+            sendValue(state.pasCadenceRpm);
+        }
+        else if (item == "CONFIG_PAS_QUADRATURE") {
+            sendValue((activeConfig.pasQuadrature ? "TRUE" : "FALSE"));
+        }
+        else if (item == "CONFIG_PAS_DIRECTION_INVERTED") {
+            sendValue((activeConfig.pasDirectionInverted ? "TRUE" : "FALSE"));
+        }
+        else if (item == "PAS_BACKPEDAL") {
+            sendValue((state.pasBackpedaling ? "TRUE" : "FALSE"));
+        }
+        else if (item == "PAS_PULSE_COUNT") {
+            sendValue(state.pasPulseCount);
+        }
+        else if (item == "CONFIG_REGEN_ENABLED") {
+            sendValue((activeConfig.regenEnabled ? "TRUE" : "FALSE"));
+        }
+        else if (item == "CONFIG_REGEN_BRAKE_AMPS") {
+            sendValue(activeConfig.regenBrakeAmps);
+        }
+        else if (item == "CONFIG_REGEN_THROTTLE_BACK_AMPS") {
+            sendValue(activeConfig.regenThrottleBackAmps);
+        }
+        else if (item == "CONFIG_REGEN_MAX_PHASE_CURRENT_AMPS") {
+            sendValue(activeConfig.regenMaxPhaseCurrentAmps);
+        }
+        else if (item == "CONFIG_REGEN_MAX_BATTERY_AMPS") {
+            sendValue(activeConfig.regenMaxBatteryAmps);
+        }
+        else if (item == "CONFIG_REGEN_VOLTAGE_CEILING") {
+            sendValue(activeConfig.regenVoltageCeiling);
+        }
+        else if (item == "CONFIG_REGEN_VOLTAGE_TAPER") {
+            sendValue(activeConfig.regenVoltageTaper);
+        }
+        else if (item == "CONFIG_REGEN_MIN_RPM") {
+            sendValue(activeConfig.regenMinRpm);
+        }
+        else if (item == "CONFIG_REGEN_BACK_EMF_MARGIN") {
+            sendValue(activeConfig.regenBackEmfMargin);
+        }
+        else if (item == "CONFIG_REGEN_MOTORING_TRIP_AMPS") {
+            sendValue(activeConfig.regenMotoringTripAmps);
+        }
+        else if (item == "CONFIG_HALL_EDGES_PER_REV") {
+            sendValue(activeConfig.hallEdgesPerRev);
+        }
+        else if (item == "CONFIG_HALL_FAULT_THRESHOLD") {
+            sendValue(activeConfig.hallFaultThreshold);
+        }
+        else if (item == "CONFIG_HALL_RECOVERY_EDGES") {
+            sendValue(activeConfig.hallRecoveryEdges);
+        }
+        else if (item == "CONFIG_SENSORLESS_MIN_RPM") {
+            sendValue(activeConfig.sensorlessMinRpm);
+        }
+        else if (item == "CONFIG_SENSORLESS_BLANKING") {
+            sendValue(activeConfig.sensorlessBlanking);
+        }
+        else if (item == "CONFIG_PHASE_VOLTAGE_DIVIDER_RATIO") {
+            sendValue(activeConfig.phaseVoltageDividerRatio);
+        }
+        else if (item == "MOTOR_COMMUTATION") {
+            sendValue(Commutation::modeName(static_cast<CommutationMode>(state.commutationMode)));
+        }
+        else if (item == "HALL_STATE") {
+            sendValue(state.hallState);
+        }
+        else if (item == "HALL_ERROR_COUNT") {
+            sendValue(state.hallErrors);
+        }
+        else if (item == "COMMUTATION_WH_PER_MILE_HALL") {
+            sendValue(state.whPerMileHall);
+        }
+        else if (item == "COMMUTATION_WH_PER_MILE_SENSORLESS") {
+            sendValue(state.whPerMileSensorless);
+        }
+        else if (item == "CONFIG_HALL_LEARN_DUTY") {
+            sendValue(activeConfig.hallLearnDuty);
+        }
+        else if (item == "CONFIG_HALL_LEARN_MAX_AMPS") {
+            sendValue(activeConfig.hallLearnMaxAmps);
         }
         else if (item == "MOTOR_RPM") {
-            Serial.println(String("VALUE ") + motor.rpm);
+            sendValue(state.rpm);
         }
         else if (item == "MOTOR_MPH") {
-            Serial.println(String("VALUE ") + motor.mph);
+            sendValue(state.mph);
         }
         else if (item == "MOTOR_POWER_WATTS") {
-            Serial.println(String("VALUE ") + motor.lastElectricalPower);
+            sendValue(state.lastElectricalPower);
         }
         else if (item == "MOTOR_BUS_VOLTAGE") {
-            Serial.println(String("VALUE ") + motor.lastBusVoltage);
+            sendValue(state.lastBusVoltage);
         }
         else if (item == "MOTOR_PHASE_CURRENT") {
-            Serial.println(String("VALUE ") + motor.lastPhaseCurrent);
+            sendValue(state.lastPhaseCurrent);
+        }
+        else if (item == "MOTOR_CURRENT_SETPOINT") {
+            sendValue(state.currentSetpointAmps);
         }
         else if (item == "MOTOR_IS_CRUISE_CONTROL") {
-            Serial.println(String("VALUE ") + (motor.isCruiseControl ? "TRUE" : "FALSE"));
+            sendValue((state.isCruiseControl ? "TRUE" : "FALSE"));
         }
         else if (item == "MOTOR_CRUISE_TARGET_MPH") {
-            Serial.println(String("VALUE ") + motor.targetMph);
+            sendValue(state.targetMph);
+        }
+        else if (item == "CRUISE_ERROR_RMS_MPH") {
+            sendValue(state.cruiseErrorRmsMph);
+        }
+        else if (item == "CRUISE_ERROR_MEAN_ABS_MPH") {
+            sendValue(state.cruiseErrorMeanAbsMph);
+        }
+        else if (item == "CRUISE_ERROR_MAX_MPH") {
+            sendValue(state.cruiseErrorMaxMph);
         }
         else if (item == "MOTOR_IS_PAS") {
-            Serial.println(String("VALUE ") + (motor.isPASMode ? "TRUE" : "FALSE"));
+            sendValue((state.isPASMode ? "TRUE" : "FALSE"));
         }
         else if (item == "MOTOR_PAS_LEVEL") {
-            Serial.println(String("VALUE ") + motor.pasLevel);
+            sendValue(state.pasLevel);
         }
         else {
             Serial.println("ERR READ");
         }
     } else if (cmd == "MOTOR") {
         if(item == "COAST") {
-            motor.COAST();
+            motor.requestCoast();
         }
         else if(item == "BRAKE") {
-            motor.BRAKE();
+            motor.requestBrake();
+        }
+        else if(item == "CLEAR_FAULT") {
+            motor.requestFaultClear();
+        }
+        else if(item == "CALIBRATE_CURRENT_SENSE") {
+            motor.requestCurrentSenseCalibration();
+        }
+        else if(item == "LEARN_HALLS") {
+            motor.requestHallLearn();
+        }
+        else if(item == "LEARN_HALL_REV_START") {
+            motor.requestHallRevolutionStart();
+        }
+        else if(item == "LEARN_HALL_REV_STOP") {
+            motor.requestHallRevolutionStop();
         }
         else {
             Serial.println("ERR MOTOR");
@@ -189,11 +601,42 @@ void UART::init() {
     Serial.begin(115200);
     Serial.println("UART initialized!");
 }
-void UART::sendMessage(String message) {
+void UART::sendMessage(const char* message) {
     Serial.println(message);
 }
-void UART::sendData(String name, String data) {
-    Serial.print(String("READ") + " " + name + " " + data);
+void UART::sendData(const char* name, const char* data) {
+    // The control task must never wait on the serial port
+    if (queuedTask != nullptr && !xPortInIsrContext() && xTaskGetCurrentTaskHandle() == queuedTask) {
+        telemetry.post(name, data);
+        return;
+    }
+    // One write per line so lines from different tasks cannot interleave
+    FixedString<DIRECT_LINE_LENGTH> line;
+    line.appendf("READ %s %s\r\n", name, data);
+    if (line.length() + 1 < DIRECT_LINE_LENGTH) {
+        Serial.write(line.c_str(), line.length());
+        return;
+    }
+    // Rare long values (the DRV8353 fault list) go out in pieces
+    Serial.print("READ ");
+    Serial.print(name);
+    Serial.print(" ");
+    Serial.println(data);
+}
+void UART::sendData(const char* name, float value, int decimals) {
+    FixedString<TelemetryRecord::VALUE_LENGTH> text;
+    text.appendFloat(value, decimals);
+    sendData(name, text.c_str());
+}
+void UART::sendData(const char* name, long value) {
+    FixedString<TelemetryRecord::VALUE_LENGTH> text;
+    text.appendf("%ld", value);
+    sendData(name, text.c_str());
+}
+void UART::sendData(const char* name, unsigned long value) {
+    FixedString<TelemetryRecord::VALUE_LENGTH> text;
+    text.appendf("%lu", value);
+    sendData(name, text.c_str());
 }
 
 
@@ -0,0 +1,90 @@
+#include <Arduino.h>
+#include "telemetry.h"
+#include "FixedString.h"
+
+static uint32_t hashName(const char* name) {
+    uint32_t hash = 2166136261u; // FNV-1a
+    while (*name) {
+        hash = (hash ^ static_cast<uint8_t>(*name++)) * 16777619u;
+    }
+    return hash;
+}
+
+static void copyField(char* destination, const char* source, size_t length) {
+    strncpy(destination, source, length - 1);
+    destination[length - 1] = '\0';
+}
+
+void Telemetry::post(const char* name, const char* value) {
+    TelemetryRecord record;
+    copyField(record.name, name, TelemetryRecord::NAME_LENGTH);
+    copyField(record.value, value, TelemetryRecord::VALUE_LENGTH);
+    if (!queue.push(record)) {
+        droppedCount.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void Telemetry::sample(const char* name, const char* value) {
+    TelemetryRecord record;
+    copyField(record.name, name, TelemetryRecord::NAME_LENGTH);
+    copyField(record.value, value, TelemetryRecord::VALUE_LENGTH);
+    store(record, true);
+}
+void Telemetry::sample(const char* name, float value, int decimals) {
+    FixedString<TelemetryRecord::VALUE_LENGTH> text;
+    text.appendFloat(value, decimals);
+    sample(name, text.c_str());
+}
+void Telemetry::sample(const char* name, long value) {
+    FixedString<TelemetryRecord::VALUE_LENGTH> text;
+    text.appendf("%ld", value);
+    sample(name, text.c_str());
+}
+void Telemetry::sample(const char* name, unsigned long value) {
+    FixedString<TelemetryRecord::VALUE_LENGTH> text;
+    text.appendf("%lu", value);
+    sample(name, text.c_str());
+}
+
+void Telemetry::store(const TelemetryRecord& record, bool onlyIfChanged) {
+    const uint32_t hash = hashName(record.name);
+    for (int i = 0; i < entryCount; ++i) {
+        if (entries[i].hash == hash && strcmp(entries[i].record.name, record.name) == 0) {
+            if (onlyIfChanged && strcmp(entries[i].record.value, record.value) == 0) {
+                return;
+            }
+            entries[i].record = record;
+            entries[i].pending = true;
+            return;
+        }
+    }
+    if (entryCount >= MAX_NAMES) {
+        droppedCount.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    entries[entryCount].hash = hash;
+    entries[entryCount].record = record;
+    entries[entryCount].pending = true;
+    entryCount++;
+}
+
+bool Telemetry::service() {
+    TelemetryRecord record;
+    while (queue.pop(record)) {
+        store(record, false);
+    }
+
+    // Round-robin so a name that changes every cycle cannot starve the others
+    for (int scanned = 0; scanned < entryCount; ++scanned) {
+        Entry& entry = entries[cursor];
+        cursor = (cursor + 1) % entryCount;
+        if (entry.pending) {
+            entry.pending = false;
+            FixedString<TelemetryRecord::NAME_LENGTH + TelemetryRecord::VALUE_LENGTH + 8> line;
+            line.appendf("READ %s %s\r\n", entry.record.name, entry.record.value);
+            Serial.write(line.c_str(), line.length());
+            return true;
+        }
+    }
+    return false;
+}
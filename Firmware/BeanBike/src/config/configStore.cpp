@@ -0,0 +1,49 @@
+#include <Arduino.h>
+#include <string.h>
+#include "configStore.h"
+#include "globals.h"
+
+// Keep the live value of a control-owned field the edit left as it found it
+template <typename T>
+static void keepLiveUnlessEdited(T& edited, const T& live, const T& base) {
+    if (memcmp(&edited, &base, sizeof(T)) == 0) {
+        memcpy(&edited, &live, sizeof(T));
+    }
+}
+
+void ConfigStore::publish() {
+    published.write(config);
+}
+
+bool ConfigStore::apply() {
+    const uint32_t version = pending.version();
+    if (version == appliedVersion || (version & 1u) != 0) {
+        return false;
+    }
+    // A write landing during the read is simply applied again next cycle
+    Edit edit = pending.read();
+    edit.edited.currentSenseGain = config.currentSenseGain;  // Read back from the DRV8353, never SET
+    keepLiveUnlessEdited(edit.edited.currentSenseOffsetVolt, config.currentSenseOffsetVolt, edit.base.currentSenseOffsetVolt);
+    keepLiveUnlessEdited(edit.edited.hallSectorTable, config.hallSectorTable, edit.base.hallSectorTable);
+    keepLiveUnlessEdited(edit.edited.hallSequenceForward, config.hallSequenceForward, edit.base.hallSequenceForward);
+    keepLiveUnlessEdited(edit.edited.hallEdgesPerRev, config.hallEdgesPerRev, edit.base.hallEdgesPerRev);
+    config = edit.edited;
+    appliedVersion = version;
+    publish();
+    return true;
+}
+
+Config& ConfigStore::beginEdit() {
+    staging.base = published.read();
+    memcpy(&staging.edited, &staging.base, sizeof(Config));  // Byte copy, padding included, so submit can memcmp
+    return staging.edited;
+}
+
+bool ConfigStore::submit() {
+    // Rejected items and MOTOR_* requests leave the edit untouched; don't re-apply an unchanged config
+    if (memcmp(&staging.edited, &staging.base, sizeof(Config)) == 0) {
+        return false;
+    }
+    pending.write(staging);
+    return true;
+}
@@ -0,0 +1,20 @@
+#include <Arduino.h>
+#include "PIController.h"
+
+void PIController::reset(float output, float feedForward) {
+    integral = constrain(output, outputMin, outputMax) - feedForward;
+}
+
+float IRAM_ATTR PIController::update(float error, float dtSec, float feedForward) {
+    const float proportional = kp * error;
+    const float candidateIntegral = integral + ki * error * dtSec;
+    const float unclamped = feedForward + proportional + candidateIntegral;
+
+    // Conditional integration: only accept integrator growth that moves the output back in range
+    if ((unclamped > outputMax && error > 0.0f) || (unclamped < outputMin && error < 0.0f)) {
+        return constrain(feedForward + proportional + integral, outputMin, outputMax);
+    }
+
+    integral = candidateIntegral;
+    return constrain(unclamped, outputMin, outputMax);
+}
@@ -0,0 +1,64 @@
+#include <Arduino.h>
+#include <cmath>
+#include "ThrottleShaper.h"
+#include "globals.h"
+
+const ThrottleProfile ThrottleShaper::PROFILES[ThrottleShaper::PROFILE_COUNT] = {
+    {"ECO", 2.0f, 0.8f, 3.0f, 0.5f},
+    {"NORMAL", 4.0f, 1.5f, 4.0f, 0.3f},
+    {"SPORT", 8.0f, 4.0f, 6.0f, 0.1f},
+};
+
+bool ThrottleShaper::applyProfile(const char* name, Config& target) {
+    for (int i = 0; i < PROFILE_COUNT; ++i) {
+        if (strcmp(name, PROFILES[i].name) == 0) {
+            target.throttleProfile = i;
+            target.throttleCutoffHz = PROFILES[i].cutoffHz;
+            target.throttleRiseRatePerSec = PROFILES[i].riseRatePerSec;
+            target.throttleFallRatePerSec = PROFILES[i].fallRatePerSec;
+            target.throttleExpo = PROFILES[i].expo;
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThrottleShaper::reset(float ratio) {
+    lowPass1 = ratio;
+    lowPass2 = ratio;
+    output = ratio;
+}
+
+float ThrottleShaper::applyCurve(float ratio) {
+    const float expo = constrain(config.throttleExpo, 0.0f, 1.0f);
+    if (expo != curveExpo) {
+        for (int i = 0; i < CURVE_POINTS; ++i) {
+            const float x = i / static_cast<float>(CURVE_POINTS - 1);
+            curve[i] = (1.0f - expo) * x + expo * x * x * x;
+        }
+        curveExpo = expo;
+    }
+
+    const float position = constrain(ratio, 0.0f, 1.0f) * (CURVE_POINTS - 1);
+    const int index = min(static_cast<int>(position), CURVE_POINTS - 2);
+    const float fraction = position - index;
+    return curve[index] + fraction * (curve[index + 1] - curve[index]);
+}
+
+float ThrottleShaper::update(float rawRatio, float dtSec) {
+    const float shaped = applyCurve(rawRatio);
+
+    // Weight derived from elapsed time, so the corner frequency holds at any loop rate
+    float alpha = 1.0f;
+    if (config.throttleCutoffHz > 0.0f) {
+        alpha = 1.0f - expf(-2.0f * PI * config.throttleCutoffHz * dtSec);
+    }
+    lowPass1 += alpha * (shaped - lowPass1);
+    lowPass2 += alpha * (lowPass1 - lowPass2);
+
+    const float maxRise = config.throttleRiseRatePerSec > 0.0f ? config.throttleRiseRatePerSec * dtSec : 1.0f;
+    const float maxFall = config.throttleFallRatePerSec > 0.0f ? config.throttleFallRatePerSec * dtSec : 1.0f;
+    output += constrain(lowPass2 - output, -maxFall, maxRise);
+    output = constrain(output, 0.0f, 1.0f);
+    return output;
+}
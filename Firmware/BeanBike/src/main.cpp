@@ -7,35 +7,136 @@ UART uart;
 DRV8353 drv8353;
 Battery battery;
 Config config;
+Adc adc;
+PulseCounter pulseCounter;
+Commutation commutation;
+ConfigStore configStore;
+Telemetry telemetry;
+TaskMonitor taskMonitor;
+PhasePwm phasePwm;
+DeadlineMonitor deadlineMonitor;
+HeapGuard heapGuard;
+
+// Task topology: motor control alone on core 1; acquisition, comms, telemetry and battery on core 0
+constexpr BaseType_t CONTROL_CORE = 1;
+constexpr BaseType_t SERVICE_CORE = 0;
+constexpr UBaseType_t CONTROL_PRIORITY = configMAX_PRIORITIES - 2;
+constexpr UBaseType_t ADC_PRIORITY = 3;
+constexpr UBaseType_t SERVICE_PRIORITY = 1;
+constexpr TickType_t CONTROL_PERIOD_TICKS = 1;      // 1 kHz control cycle
+constexpr TickType_t BATTERY_PERIOD_TICKS = pdMS_TO_TICKS(100);
+constexpr uint32_t TASK_REPORT_INTERVAL_MS = 1000;
+constexpr uint32_t MOTOR_SAMPLE_INTERVAL_MS = 50;  // Motor telemetry rate, independent of the control rate
+
+void controlTask(void *pvParameters) {
+  uart.setQueuedTask(xTaskGetCurrentTaskHandle());
+  deadlineMonitor.init();
+  heapGuard.watchCurrentTask();
+  TickType_t lastWake = xTaskGetTickCount();
+  while (true) {
+    taskMonitor.beginWork(TaskId::Control);
+    deadlineMonitor.beginCycle();
+    configStore.apply();  // SET commands take effect here, never mid-cycle
+    motor.applyRequests();
+    motor.sampleInputs();
+    motor.updateFaultTrip();
+    motor.CalculateSpeed();
+    // Highest priority first: the first source to claim the bridge is the only one that drives it
+    motor.updateThrottleControl();
+    motor.updateCruiseControl();
+    motor.updatePASControl();
+    motor.updateCurrentSenseCalibration();
+    motor.updateHallLearning();
+    motor.publishState();
+    deadlineMonitor.endCycle();
+    heapGuard.endCycle();
+    taskMonitor.endWork(TaskId::Control);
+    vTaskDelayUntil(&lastWake, CONTROL_PERIOD_TICKS);
+  }
+}
+
 void uartReceiveCommandTask(void *pvParameters) {
   while (true) {
+    taskMonitor.beginWork(TaskId::UartReceive);
     uart.receiveCommand();  // Poll for commands
+    taskMonitor.endWork(TaskId::UartReceive);
     vTaskDelay(10 / portTICK_PERIOD_MS);
   }
 }
 
+void adcAcquisitionTask(void *pvParameters) {
+  while (true) {
+    if (!adc.readFrame()) {  // Blocks on the DMA frame, not on the converter
+      vTaskDelay(1);         // DMA not running; don't starve the lower-priority core 0 tasks
+      continue;
+    }
+    taskMonitor.beginWork(TaskId::AdcAcquire);
+    adc.publishFrame();
+    taskMonitor.endWork(TaskId::AdcAcquire);
+  }
+}
+
+void telemetryTask(void *pvParameters) {
+  uint32_t lastReport = millis();
+  uint32_t lastSample = millis();
+  while (true) {
+    taskMonitor.beginWork(TaskId::Telemetry);
+    if (millis() - lastSample >= MOTOR_SAMPLE_INTERVAL_MS) {
+      lastSample = millis();
+      motor.reportState();
+    }
+    const bool printed = telemetry.service();
+    if (millis() - lastReport >= TASK_REPORT_INTERVAL_MS) {
+      lastReport = millis();
+      taskMonitor.report();
+      deadlineMonitor.report();
+    }
+    taskMonitor.endWork(TaskId::Telemetry);
+    if (!printed) {
+      vTaskDelay(1);
+    }
+  }
+}
+
+void batteryTask(void *pvParameters) {
+  TickType_t lastWake = xTaskGetTickCount();
+  while (true) {
+    taskMonitor.beginWork(TaskId::Battery);
+    battery.updateBatteryStatus();
+    drv8353.scrubNextRegister();  // One register per tick: a full pass every 600 ms
+    taskMonitor.endWork(TaskId::Battery);
+    vTaskDelayUntil(&lastWake, BATTERY_PERIOD_TICKS);
+  }
+}
+
+static TaskHandle_t startTask(TaskFunction_t function, TaskId id, const char* name, uint32_t stackBytes,
+                              UBaseType_t priority, BaseType_t core) {
+  TaskHandle_t handle = nullptr;
+  xTaskCreatePinnedToCore(function, name, stackBytes, NULL, priority, &handle, core);
+  taskMonitor.registerTask(id, name, handle);
+  return handle;
+}
+
 void setup() {
   pins.initPins();
   uart.init();
+  adc.init();
+  pulseCounter.init();
+  phasePwm.init();
+  startTask(adcAcquisitionTask, TaskId::AdcAcquire, "ADC", 2048, ADC_PRIORITY, SERVICE_CORE);
   drv8353.init();
-  battery.updateBatteryStatus();
-  xTaskCreatePinnedToCore(
-    uartReceiveCommandTask, 
-    "UARTReceive",    
-    2048,         
-    NULL,           
-    1,        
-    NULL,            
-    0   
-  );
-}
+  motor.calibrateCurrentSense();
+  configStore.publish();
 
+  // READ/SET copy Config and MotorState snapshots onto the stack
+  startTask(uartReceiveCommandTask, TaskId::UartReceive, "UART", 4096, SERVICE_PRIORITY, SERVICE_CORE);
+  startTask(telemetryTask, TaskId::Telemetry, "TELEMETRY", 3072, SERVICE_PRIORITY, SERVICE_CORE);
+  startTask(batteryTask, TaskId::Battery, "BATTERY", 2048, SERVICE_PRIORITY, SERVICE_CORE);
 
+  startTask(controlTask, TaskId::Control, "CONTROL", 8192, CONTROL_PRIORITY, CONTROL_CORE);
+}
 
 void loop() {
-  motor.CalculateSpeed();
-  motor.updateCruiseControl();
-  motor.updatePASControl();
-  motor.updateThrottleControl();
-  battery.updateBatteryStatus();
-}
\ No newline at end of file
+  // Everything runs in the pinned tasks created in setup()
+  vTaskDelete(NULL);
+}
@@ -0,0 +1,233 @@
+#include <Arduino.h>
+#include "commutation.h"
+#include "globals.h"
+
+constexpr uint16_t PWM_OFF = 0;
+
+// Six-step table indexed by sector: phase driven high, phase held low, floating phase
+struct Step {
+    uint8_t high;
+    uint8_t low;
+    uint8_t floating;
+};
+static const Step STEPS[6] = {
+    {0, 1, 2}, // A+ B-
+    {0, 2, 1}, // A+ C-
+    {1, 2, 0}, // B+ C-
+    {1, 0, 2}, // B+ A-
+    {2, 0, 1}, // C+ A-
+    {2, 1, 0}, // C+ B-
+};
+
+static uint8_t readHallState() {
+    return HallInputs::read();  // All three halls from one GPIO register load
+}
+
+static bool phaseVoltageSenseFitted() {
+    return Pins::MOTOR_VSENSE_A.pin >= 0 && Pins::MOTOR_VSENSE_B.pin >= 0 && Pins::MOTOR_VSENSE_C.pin >= 0;
+}
+
+const char* Commutation::modeName(CommutationMode mode) {
+    switch (mode) {
+        case CommutationMode::Hall: return "HALL";
+        case CommutationMode::Sensorless: return "SENSORLESS";
+        default: return "FAULT";
+    }
+}
+
+void Commutation::setMode(CommutationMode mode) {
+    if (mode == activeMode) {
+        return;
+    }
+    activeMode = mode;
+    commutationPending = false;
+    uart.sendData("MOTOR_COMMUTATION", modeName(mode));
+}
+
+// Returns true once enough consecutive bad events have been seen to distrust the halls
+bool Commutation::monitorHalls(uint8_t hallSector, uint32_t newEdges, bool stateChanged) {
+    if (!stateChanged && newEdges == 0) {
+        return hallErrorRun >= config.hallFaultThreshold;
+    }
+
+    bool bad = hallSector == INVALID_SECTOR;
+
+    // Only a single edge since the last read can be checked for adjacency; several edges may skip sectors
+    if (!bad && newEdges == 1 && lastHallSector != INVALID_SECTOR && hallSector != lastHallSector) {
+        const uint8_t forward = (lastHallSector + 1) % 6;
+        const uint8_t backward = (lastHallSector + 5) % 6;
+        bad = hallSector != forward && hallSector != backward;
+    }
+
+    if (bad) {
+        hallErrorCount++;
+        hallValidRun = 0;
+        if (hallErrorRun < UINT8_MAX) {
+            hallErrorRun++;
+        }
+        uart.sendData("HALL_ERROR_COUNT", hallErrorCount);
+    } else if (newEdges > 0) {
+        hallErrorRun = 0;
+        if (hallValidRun < UINT16_MAX) {
+            hallValidRun++;
+        }
+    }
+
+    if (hallSector != INVALID_SECTOR) {
+        lastHallSector = hallSector;
+    }
+    return hallErrorRun >= config.hallFaultThreshold;
+}
+
+void Commutation::update(const AdcSnapshot& inputs, float busVoltage, float rpm) {
+    const uint8_t previousState = lastHallState;
+    lastHallState = readHallState();
+    const uint8_t hallSector = config.hallSectorTable[lastHallState];
+    const uint32_t hallEdges = pulseCounter.hallEdges();
+    const uint32_t newEdges = hallEdges - lastHallEdges;
+    lastHallEdges = hallEdges;
+
+    const bool hallsFailed = monitorHalls(hallSector, newEdges, lastHallState != previousState);
+    const bool forceSensorless = config.commutationOverride == 2;
+    const bool forceHall = config.commutationOverride == 1;
+
+    if (activeMode == CommutationMode::Hall) {
+        edgeTotal += newEdges;
+        if (hallSector != INVALID_SECTOR) {
+            sector = hallSector;
+        }
+        if ((hallsFailed && !forceHall) || forceSensorless) {
+            enterSensorless(rpm);
+        }
+        return;
+    }
+
+    // Halls have produced a clean run again; hand control back unless sensorless is forced
+    const bool hallsRecovered = !hallsFailed && hallValidRun >= config.hallRecoveryEdges;
+    if (!forceSensorless && (forceHall || hallsRecovered)) {
+        hallErrorRun = 0;
+        setMode(CommutationMode::Hall);
+        return;
+    }
+
+    if (activeMode == CommutationMode::Fault) {
+        enterSensorless(rpm);
+        return;
+    }
+    updateSensorless(inputs, busVoltage);
+}
+
+void Commutation::enterSensorless(float rpm) {
+    if (!phaseVoltageSenseFitted()) {
+        if (activeMode != CommutationMode::Fault) {
+            uart.sendData("SENSORLESS_UNAVAILABLE", "NO_PHASE_VOLTAGE_SENSE");
+        }
+        setMode(CommutationMode::Fault);
+        return;
+    }
+    // Zero crossings are only visible with enough back-EMF; until then the rider pedals
+    if (rpm < config.sensorlessMinRpm || config.hallEdgesPerRev <= 0) {
+        setMode(CommutationMode::Fault);
+        return;
+    }
+
+    stepPeriodMicros = static_cast<uint32_t>(60000000.0f / (rpm * config.hallEdgesPerRev));
+    lastStepMicros = micros();
+    if (lastHallSector != INVALID_SECTOR) {
+        sector = lastHallSector;
+    }
+    setMode(CommutationMode::Sensorless);
+}
+
+void Commutation::updateSensorless(const AdcSnapshot& inputs, float busVoltage) {
+    const uint32_t nowMicros = micros();
+
+    // Commutate 30 electrical degrees (half a step) after the zero crossing
+    if (commutationPending) {
+        if (nowMicros - zeroCrossMicros >= stepPeriodMicros / 2) {
+            sector = (sector + 1) % 6;
+            lastStepMicros = nowMicros;
+            commutationPending = false;
+            edgeTotal++;
+        }
+        return;
+    }
+
+    // Lost sync: no crossing where one should have been
+    if (nowMicros - lastStepMicros > 2 * stepPeriodMicros) {
+        uart.sendData("SENSORLESS_SYNC_LOST", nowMicros - lastStepMicros);
+        setMode(CommutationMode::Fault);
+        return;
+    }
+
+    // Skip the demagnetization ringing right after a step, and frames already examined
+    const uint32_t sinceStep = nowMicros - lastStepMicros;
+    if (inputs.sequence == lastAdcSequence || sinceStep < config.sensorlessBlanking * stepPeriodMicros) {
+        return;
+    }
+    lastAdcSequence = inputs.sequence;
+
+    const uint8_t floating = STEPS[sector].floating;
+    const float phaseVoltage = inputs.volts[static_cast<int>(AdcChannel::PhaseVoltA) + floating] *
+                               config.phaseVoltageDividerRatio;
+    const float neutral = busVoltage * 0.5f;
+    const bool rising = (sector & 1u) != 0;
+    const bool crossed = rising ? phaseVoltage > neutral : phaseVoltage < neutral;
+    if (!crossed) {
+        return;
+    }
+
+    // Half a step has passed since the previous commutation; smooth the period estimate
+    stepPeriodMicros = (3 * stepPeriodMicros + 2 * sinceStep) / 4;
+    zeroCrossMicros = nowMicros;
+    commutationPending = true;
+}
+
+void Commutation::drive(uint16_t pwm) {
+    // A gate driver register that will not stay configured is as bad as no position, and
+    // without current sense there is nothing to close the current loop on
+    const PwmTrip trip = phasePwm.trip();
+    if (activeMode == CommutationMode::Fault || !drv8353.isHealthy() || !adc.ready() ||
+        trip == PwmTrip::DriverFault || trip == PwmTrip::Deadline) {
+        drv8353.setPhaseEnables(false, false, false);
+        drv8353.send3PWMMotorSignal(PWM_OFF, PWM_OFF, PWM_OFF);
+        return;
+    }
+
+    driveSector(sector, pwm);
+}
+
+void Commutation::driveSector(uint8_t stepIndex, uint16_t pwm) {
+    const Step& step = STEPS[stepIndex % 6];
+    uint16_t phasePwm[3] = {PWM_OFF, PWM_OFF, PWM_OFF};
+    phasePwm[step.high] = pwm;
+    bool enabled[3] = {true, true, true};
+    enabled[step.floating] = false;
+
+    drv8353.setPhaseEnables(enabled[0], enabled[1], enabled[2]);
+    drv8353.send3PWMMotorSignal(phasePwm[0], phasePwm[1], phasePwm[2]);
+}
+
+// Phase currents are positive into the winding, so motoring pushes current into the high phase
+// and out of the low one; regen reverses both
+float Commutation::pairCurrent(const float phaseAmps[3]) const {
+    const Step& step = STEPS[sector];
+    return 0.5f * (phaseAmps[step.high] - phaseAmps[step.low]);
+}
+
+void Commutation::accumulateEfficiency(float powerW, float mph, float dtSec) {
+    if (activeMode == CommutationMode::Fault || powerW <= 0.0f) {
+        return;
+    }
+    const int index = static_cast<int>(activeMode);
+    energyJoules[index] += powerW * dtSec;
+    distanceMiles[index] += mph * dtSec / 3600.0f;
+}
+
+float Commutation::whPerMile(CommutationMode mode) const {
+    const int index = static_cast<int>(mode);
+    if (index >= MODE_COUNT || distanceMiles[index] <= 0.0f) {
+        return 0.0f;
+    }
+    return (energyJoules[index] / 3600.0f) / distanceMiles[index];
+}
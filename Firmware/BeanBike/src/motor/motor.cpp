@@ -2,135 +2,348 @@
 #include <cmath>
 #include "motor.h"
 #include "globals.h"
+#include "PIController.h"
+#include "ThrottleShaper.h"
+#include "FixedString.h"
 
-int hallEdgeCount = 0;
-const int PULSES_PER_MECH_REV = 138; // Adjust as needed to make accurate
 const int SAMPLE_MS = 100;
+constexpr uint32_t CSA_CAL_SETTLE_US = 200; // Amplifier output settling after shorting inputs
+constexpr uint32_t CSA_CAL_FRAME_TIMEOUT_MS = 50;
+constexpr int SENSE_A_CHANNEL = static_cast<int>(AdcChannel::SenseA);
+
+constexpr float PWM_MAX = (1 << 16) - 1;
+constexpr float MAX_CONTROL_DT_SEC = 0.05f; // Longer gaps mean the loop was idle, not late
+
+static uint32_t lastCurrentSenseCalMillis = 0;
+static PIController currentLoop;
+static bool currentLoopEngaged = false;
+static uint32_t lastCurrentLoopMicros = 0;
+static AdcSnapshot inputs; // Coherent view of every analog input for the current control cycle
+static bool bridgeClaimed = false; // Set by the one drive source that owns the bridge this cycle
+
+constexpr uint32_t CRUISE_STATS_WINDOW_MS = 1000;
+
+static PIController speedLoop;
+static bool cruiseEngaged = false;
+static uint32_t lastCruiseMicros = 0;
+
+static PIController regenLoop;
+static bool regenEngaged = false;
+static uint32_t lastRegenMicros = 0;
+constexpr uint32_t REGEN_MOTORING_LOCKOUT_MS = 500; // Coast this long after regen drew motoring current
+static uint32_t regenLockoutStartMillis = 0;
+static bool regenLockedOut = false;
+
+static ThrottleShaper throttleShaper;
+static uint32_t lastThrottleMicros = 0;
+
+static PwmTrip lastPwmTrip = PwmTrip::None;
+
+struct TrackingStats {
+    float sumSquares;
+    float sumAbs;
+    float maxAbs;
+    uint32_t samples;
+    uint32_t windowStartMillis;
+};
+static TrackingStats cruiseStats;
+
+constexpr uint8_t PAS_PERIOD_RING_SIZE = 8;   // Power of two
+constexpr uint8_t PAS_PERIOD_RING_MASK = PAS_PERIOD_RING_SIZE - 1;
+constexpr uint8_t PAS_CADENCE_AVERAGE_PULSES = 4;
+constexpr uint32_t PAS_STOP_PERIOD_FACTOR = 2; // Missing pulses for this many periods = stopped
+constexpr int PAS_MAX_LEVEL = Config::PAS_LEVEL_COUNT - 1;
 
-constexpr uint32_t PAS_ACTIVITY_TIMEOUT_US = 600000; // 0.6 s without pulses = not pedaling
-constexpr float PAS_ASSIST_RATIOS[] = {0.0f, 0.25f, 0.4f, 0.6f, 0.8f, 1.0f};
-constexpr int PAS_MAX_LEVEL = (sizeof(PAS_ASSIST_RATIOS) / sizeof(PAS_ASSIST_RATIOS[0])) - 1;
-
-volatile uint32_t pasPulseCount = 0;
 volatile uint32_t lastPasPulseMicros = 0;
-
-float readAdcVoltage(const PinDef& pin) {
-    if (config.adcResolutionBits <= 0 || config.adcReferenceVoltage <= 0.0f) {
-        return 0.0f;
-    }
-
-    static bool resolutionConfigured = false;
-    if (!resolutionConfigured) {
-        analogReadResolution(config.adcResolutionBits);
-        resolutionConfigured = true;
-    }
-
-    const int raw = analogRead(pin.pin);
-    const float maxCount = static_cast<float>((1 << config.adcResolutionBits) - 1);
-    if (maxCount <= 0.0f) {
-        return 0.0f;
+volatile uint32_t pasPeriodRing[PAS_PERIOD_RING_SIZE];
+volatile uint8_t pasPeriodHead = 0;
+volatile uint8_t pasPeriodCount = 0;
+volatile uint32_t pasMaxPeriodUs = 500000;    // Refreshed from config.pasMinCadenceRpm
+volatile bool pasBackpedal = false;
+
+void Motor::sampleInputs() {
+    inputs = adc.snapshot();
+    const float senseGain = drv8353.senseGain();  // Tracks the scrubbed CSA_CONTROL readback
+    if (senseGain != config.currentSenseGain) {
+        config.currentSenseGain = senseGain;
+        configStore.publish();
     }
-
-    return (static_cast<float>(raw) / maxCount) * config.adcReferenceVoltage;
+    pulseCounter.poll();
+    commutation.update(inputs, battery.getBatteryVoltage(), rpm);
+    driveSource = DriveSource::None;  // Whichever path drives the bridge this cycle claims it
+    bridgeClaimed = false;
+    drivePwm = 0;
+    currentRequestAmps = 0.0f;
+    currentLimitActive = false;
 }
 
-float readPhaseCurrentAmps(const PinDef& pin) {
+float IRAM_ATTR readPhaseCurrentAmps(int phase) {
     const float shuntOhms = config.shuntResistanceMilliOhm * 0.001f;
     if (shuntOhms <= 0.0f || config.currentSenseGain <= 0.0f) {
         return 0.0f;
     }
 
-    const float voltage = readAdcVoltage(pin);
-    const float senseVoltage = voltage - config.currentSenseOffsetVolt;
+    const float voltage = inputs.volts[SENSE_A_CHANNEL + phase];
+    const float senseVoltage = voltage - config.currentSenseOffsetVolt[phase];
     const float current = senseVoltage / (config.currentSenseGain * shuntOhms);
     return current;
 }
 
-float readAveragePhaseCurrentMagnitude() {
-    const float ia = fabsf(readPhaseCurrentAmps(Pins::MOTOR_SOA));
-    const float ib = fabsf(readPhaseCurrentAmps(Pins::MOTOR_SOB));
-    const float ic = fabsf(readPhaseCurrentAmps(Pins::MOTOR_SOC));
+// Signed current of the energised phase pair; positive while motoring, negative while braking
+static float readPairCurrentAmps() {
+    const float phaseAmps[3] = {readPhaseCurrentAmps(0), readPhaseCurrentAmps(1), readPhaseCurrentAmps(2)};
+    return commutation.pairCurrent(phaseAmps);
+}
+
+float IRAM_ATTR readAveragePhaseCurrentMagnitude() {
+    const float ia = fabsf(readPhaseCurrentAmps(0));
+    const float ib = fabsf(readPhaseCurrentAmps(1));
+    const float ic = fabsf(readPhaseCurrentAmps(2));
     return (ia + ib + ic) / 3.0f;
 }
 
-static int applyPowerLimit(Motor& m, int requestedPwm) {
-    if (requestedPwm <= 0 || config.maxMotorWattage <= 0) {
+// Battery current is roughly phase current scaled by duty; below this duty the phase limit governs
+constexpr float BATTERY_LIMIT_MIN_DUTY = 0.05f;
+
+static float currentLimitAmps(const Motor& m) {
+    float limit = config.maxPhaseCurrentAmps;
+    if (config.maxMotorWattage > 0 && m.lastBusVoltage > 1.0f) {
+        limit = min(limit, static_cast<float>(config.maxMotorWattage) / m.lastBusVoltage);
+    }
+    if (config.maxBatteryCurrentAmps > 0.0f) {
+        limit = min(limit, config.maxBatteryCurrentAmps / max(m.dutyCommand, BATTERY_LIMIT_MIN_DUTY));
+    }
+    return max(limit, 0.0f);
+}
+
+// Wheel-speed duty at which the bridge neither drives nor brakes the motor
+static float backEmfDuty(const Motor& m) {
+    if (config.maxMotorRPM <= 0.0f) {
+        return 0.0f;
+    }
+    return constrain(m.rpm / config.maxMotorRPM, 0.0f, 1.0f);
+}
+
+static int applyCurrentControl(Motor& m, float requestedAmps) {
+    const uint32_t nowMicros = micros();
+    float dtSec = (nowMicros - lastCurrentLoopMicros) * 1e-6f;
+    lastCurrentLoopMicros = nowMicros;
+
+    if (requestedAmps <= 0.0f || !adc.ready()) {
         m.lastBusVoltage = 0.0f;
         m.lastElectricalPower = 0.0f;
         m.lastPhaseCurrent = 0.0f;
-        uart.sendData("MOTOR_POWER_LIMIT_ACTIVE", "FALSE");
-        return requestedPwm;
+        m.currentSetpointAmps = 0.0f;
+        m.dutyCommand = 0.0f;
+        m.currentRequestAmps = 0.0f;
+        m.currentLimitActive = false;
+        m.drivePwm = 0;
+        currentLoop.reset();
+        currentLoopEngaged = false;
+        return 0;
+    }
+
+    // The loop was not running (mode just engaged). Start at the back-EMF duty, where the bridge
+    // neither drives nor brakes; zero duty at speed would short the windings and brake hard.
+    if (!currentLoopEngaged || dtSec > MAX_CONTROL_DT_SEC) {
+        m.dutyCommand = backEmfDuty(m);
+        currentLoop.reset(m.dutyCommand);
+        currentLoopEngaged = true;
+        dtSec = 0.0f;
     }
 
+    // Regulate by sign, as regen does: a magnitude cannot tell braking from motoring, and the
+    // three-phase average reads only 2/3 of the energised pair's current
     m.lastBusVoltage = battery.getBatteryVoltage();
-    m.lastPhaseCurrent = readAveragePhaseCurrentMagnitude();
+    m.lastPhaseCurrent = readPairCurrentAmps();
     m.lastElectricalPower = m.lastBusVoltage * m.lastPhaseCurrent;
 
-    uart.sendData("MOTOR_BUS_VOLT", String(m.lastBusVoltage, 2));
-    uart.sendData("MOTOR_PHASE_CURRENT", String(m.lastPhaseCurrent, 2));
-    uart.sendData("MOTOR_POWER_W", String(m.lastElectricalPower, 1));
+    const float limitAmps = currentLimitAmps(m);
+    const bool limited = requestedAmps > limitAmps;
+    m.currentSetpointAmps = limited ? limitAmps : requestedAmps;
+
+    currentLoop.kp = config.currentLoopKp;
+    currentLoop.ki = config.currentLoopKi;
+    m.dutyCommand = currentLoop.update(m.currentSetpointAmps - m.lastPhaseCurrent, dtSec);
+    const int pwmValue = static_cast<int>(roundf(m.dutyCommand * PWM_MAX));
+
+    m.currentRequestAmps = requestedAmps;
+    m.currentLimitActive = limited;
+    m.drivePwm = pwmValue;
+    return pwmValue;
+}
 
-    if (m.lastElectricalPower <= static_cast<float>(config.maxMotorWattage)) {
-        uart.sendData("MOTOR_POWER_LIMIT_ACTIVE", "FALSE");
-        return requestedPwm;
+static float regenLimitAmps(const Motor& m, float busVoltage) {
+    float limit = config.regenMaxPhaseCurrentAmps;
+    if (config.regenMaxBatteryAmps > 0.0f) {
+        limit = min(limit, config.regenMaxBatteryAmps / max(m.dutyCommand, BATTERY_LIMIT_MIN_DUTY));
     }
+    // Fade out over the taper band below the ceiling so a full pack is never pushed past it
+    if (config.regenVoltageTaper > 0.0f) {
+        limit *= constrain((config.regenVoltageCeiling - busVoltage) / config.regenVoltageTaper, 0.0f, 1.0f);
+    } else if (busVoltage >= config.regenVoltageCeiling) {
+        limit = 0.0f;
+    }
+    return max(limit, 0.0f);
+}
 
-    const float limitRatio = static_cast<float>(config.maxMotorWattage) / m.lastElectricalPower;
-    const float clampedRatio = constrain(limitRatio, 0.0f, 1.0f);
-    const int limitedPwm = static_cast<int>(roundf(requestedPwm * clampedRatio));
-    uart.sendData("MOTOR_POWER_LIMIT_ACTIVE", "TRUE");
-    uart.sendData("MOTOR_POWER_LIMIT_PWM", String(limitedPwm));
-    return limitedPwm;
+static void releaseRegen() {
+    if (regenEngaged) {
+        regenEngaged = false;
+        phasePwm.armBrakeTrip(true);
+        uart.sendData("REGEN_ACTIVE", "FALSE");
+    }
 }
 
+// Brake with `requestedAmps` of phase current by holding duty below the back-EMF duty.
+// Returns the PWM value, or -1 when the wheel is too slow to regenerate or regen is locked
+// out after drawing motoring current; the caller coasts.
+static int applyRegenControl(Motor& m, float requestedAmps) {
+    if (regenLockedOut && millis() - regenLockoutStartMillis >= REGEN_MOTORING_LOCKOUT_MS) {
+        regenLockedOut = false;
+    }
+    if (!config.regenEnabled || requestedAmps <= 0.0f || m.rpm < config.regenMinRpm || !adc.ready() ||
+        regenLockedOut) {
+        releaseRegen();
+        return -1;
+    }
 
+    const uint32_t nowMicros = micros();
+    float dtSec = (nowMicros - lastRegenMicros) * 1e-6f;
+    lastRegenMicros = nowMicros;
+
+    // The rpm-based estimate can sit above the real back-EMF; a margin keeps the ceiling braking
+    const float dutyCeiling = backEmfDuty(m) * constrain(1.0f - config.regenBackEmfMargin, 0.0f, 1.0f);
+    if (!regenEngaged || dtSec > MAX_CONTROL_DT_SEC) {
+        // Start at the ceiling and let the loop pull it down
+        regenLoop.reset();
+        dtSec = 0.0f;
+        drv8353.setBrake(false);
+        regenEngaged = true;
+        phasePwm.armBrakeTrip(false);
+        uart.sendData("REGEN_ACTIVE", "TRUE");
+    }
 
-static float updatePasCadence(Motor& m) {
-    static uint32_t lastSampleMicros = 0;
-    static uint32_t lastPulseCount = 0;
+    // Regulate braking current by sign: a magnitude cannot tell braking from motoring, and a
+    // loop fed one would push duty up while the lever is motoring the wheel
+    const float brakingAmps = -readPairCurrentAmps();
+    if (brakingAmps < -config.regenMotoringTripAmps) {
+        regenLockedOut = true;
+        regenLockoutStartMillis = millis();
+        releaseRegen();
+        uart.sendData("REGEN_MOTORING", -brakingAmps, 2);
+        return -1;
+    }
 
-    uint32_t pulseCountSnapshot;
-    noInterrupts();
-    pulseCountSnapshot = pasPulseCount;
-    interrupts();
+    m.lastBusVoltage = battery.getBatteryVoltage();
+    m.lastPhaseCurrent = brakingAmps;
+    m.lastElectricalPower = -m.lastBusVoltage * brakingAmps;
+
+    const float limitAmps = regenLimitAmps(m, m.lastBusVoltage);
+    const bool limited = requestedAmps > limitAmps;
+    const float targetAmps = limited ? limitAmps : requestedAmps;
+    m.currentSetpointAmps = -targetAmps;
+
+    regenLoop.kp = config.currentLoopKp;
+    regenLoop.ki = config.currentLoopKi;
+    regenLoop.outputMax = dutyCeiling;
+    const float dutyReduction = regenLoop.update(targetAmps - brakingAmps, dtSec);
+    m.dutyCommand = dutyCeiling - dutyReduction;
+    const int pwmValue = static_cast<int>(roundf(m.dutyCommand * PWM_MAX));
+
+    m.driveSource = DriveSource::Regen;
+    m.currentRequestAmps = requestedAmps;
+    m.currentLimitActive = limited;
+    m.drivePwm = pwmValue;
+    return pwmValue;
+}
 
-    const uint32_t nowMicros = micros();
-    if (lastSampleMicros == 0) {
-        lastPulseCount = pulseCountSnapshot;
-        lastSampleMicros = nowMicros;
-        m.pasCadenceRpm = 0.0f;
-        return m.pasCadenceRpm;
+// No drive source and no regen: float the bridge and drop the current loop, so neither the
+// last sector/duty nor a stale integrator survives into the next command
+static void coastBridge(Motor& m) {
+    currentLoop.reset();
+    currentLoopEngaged = false;
+    m.dutyCommand = 0.0f;
+    m.currentSetpointAmps = 0.0f;
+    m.driveSource = DriveSource::None;
+    m.drivePwm = 0;
+    drv8353.send3PWMMotorSignal(0, 0, 0);
+    drv8353.setCoast(true);
+}
+
+// Cadence from the most recent pulse periods; between pulses the estimate can only fall
+static float estimatePasCadence() {
+    if (config.pasPulsesPerRev <= 0) {
+        return 0.0f;
     }
 
-    if (pulseCountSnapshot < lastPulseCount) {
-        lastPulseCount = pulseCountSnapshot;
-        lastSampleMicros = nowMicros;
-        m.pasCadenceRpm = 0.0f;
-        return m.pasCadenceRpm;
+    uint32_t periodSum = 0;
+    noInterrupts();
+    const bool backpedaling = pasBackpedal;
+    const uint32_t lastPulseMicrosSnapshot = lastPasPulseMicros;
+    const uint8_t storedPeriods = pasPeriodCount;
+    const uint8_t periodCount = min(storedPeriods, PAS_CADENCE_AVERAGE_PULSES);
+    const uint32_t newestPeriod = pasPeriodRing[(pasPeriodHead - 1) & PAS_PERIOD_RING_MASK];
+    for (uint8_t i = 0; i < periodCount; ++i) {
+        periodSum += pasPeriodRing[(pasPeriodHead - 1 - i) & PAS_PERIOD_RING_MASK];
     }
+    interrupts();
 
-    const uint32_t deltaCount = pulseCountSnapshot - lastPulseCount;
-    const uint32_t deltaMicros = nowMicros - lastSampleMicros;
+    if (backpedaling || periodCount == 0 || lastPulseMicrosSnapshot == 0) {
+        return 0.0f;
+    }
 
-    if (deltaCount == 0 || deltaMicros == 0 || config.pasPulsesPerRev <= 0) {
-        return m.pasCadenceRpm;
+    const uint32_t elapsed = micros() - lastPulseMicrosSnapshot;
+    if (elapsed > PAS_STOP_PERIOD_FACTOR * newestPeriod || elapsed > pasMaxPeriodUs) {
+        return 0.0f;
     }
 
-    const float pedalRevs = deltaCount / static_cast<float>(config.pasPulsesPerRev);
-    m.pasCadenceRpm = (pedalRevs * 60000000.0f) / static_cast<float>(deltaMicros);
+    const float period = max(static_cast<float>(periodSum) / periodCount, static_cast<float>(elapsed));
+    return 60000000.0f / (period * config.pasPulsesPerRev);
+}
 
-    lastPulseCount = pulseCountSnapshot;
-    lastSampleMicros = nowMicros;
+static float updatePasCadence(Motor& m) {
+    if (config.pasPulsesPerRev > 0 && config.pasMinCadenceRpm > 0.0f) {
+        pasMaxPeriodUs = static_cast<uint32_t>(60000000.0f / (config.pasMinCadenceRpm * config.pasPulsesPerRev));
+    }
+    m.pasCadenceRpm = estimatePasCadence();
+    m.pasBackpedaling = pasBackpedal;
     return m.pasCadenceRpm;
 }
 
-void Motor::onHallChange() {
-    hallEdgeCount++;
-}
+void IRAM_ATTR Motor::onPasPulse() {
+    const uint32_t nowMicros = micros();
+    const uint32_t period = nowMicros - lastPasPulseMicros;
+    const bool firstPulse = lastPasPulseMicros == 0;
+    lastPasPulseMicros = nowMicros;
+
+    // Quadrature sensors: channel B level on A's rising edge gives the crank direction
+    if (config.pasQuadrature) {
+        const bool reverse = PasDirInput::read() != config.pasDirectionInverted;
+        if (reverse) {
+            pasBackpedal = true;
+            pasPeriodCount = 0;
+            return;
+        }
+        if (pasBackpedal) {
+            // First forward pulse after backpedaling; the gap since the reverse pulse is not a cadence period
+            pasBackpedal = false;
+            pasPeriodCount = 0;
+            return;
+        }
+    }
 
-void Motor::onPasPulse() {
-    pasPulseCount++;
-    lastPasPulseMicros = micros();
+    // A gap longer than the slowest cadence means pedaling restarted; old periods are stale
+    if (firstPulse || period > pasMaxPeriodUs) {
+        pasPeriodCount = 0;
+        return;
+    }
+
+    pasPeriodRing[pasPeriodHead] = period;
+    pasPeriodHead = (pasPeriodHead + 1) & PAS_PERIOD_RING_MASK;
+    if (pasPeriodCount < PAS_PERIOD_RING_SIZE) {
+        pasPeriodCount++;
+    }
 }
 
 
@@ -148,93 +361,102 @@ void Motor::CalculateSpeed(){
     uint32_t now = millis();
     if (now - lastSample < SAMPLE_MS) return;
 
-    noInterrupts();
-    uint32_t countSnapshot = hallEdgeCount;
-    interrupts();
+    uint32_t countSnapshot = commutation.edgeCount();
 
     uint32_t deltaCount = countSnapshot - lastCount;
     float intervalSec = (now - lastSample) / 1000.0f;
-    float mechRevs = deltaCount / static_cast<float>(PULSES_PER_MECH_REV);
+    float mechRevs = config.hallEdgesPerRev > 0 ? deltaCount / static_cast<float>(config.hallEdgesPerRev) : 0.0f;
     rpm = (mechRevs / intervalSec) * 60.0f;
 
-    uart.sendData("MOTOR_RPM", String(rpm));
-
     lastCount = countSnapshot;
     lastSample = now;
     mph = rpm * wheelFactorMphPerRpm();
-    uart.sendData("MOTOR_SPEED_MPH", String(mph, 2));
+
+    commutation.accumulateEfficiency(lastElectricalPower, mph, intervalSec);
 }
+// Bilinear lookup in config.pasAssistMap; cadence outside the breakpoints holds the edge value
+static float evaluateAssistMap(float level, float cadenceRpm) {
+    level = constrain(level, 0.0f, static_cast<float>(PAS_MAX_LEVEL));
+    const int row0 = static_cast<int>(level);
+    const int row1 = min(row0 + 1, PAS_MAX_LEVEL);
+    const float rowWeight = level - row0;
+
+    const float* breakpoints = config.pasCadenceBreakpointsRpm;
+    int col0 = 0;
+    int col1 = 0;
+    float colWeight = 0.0f;
+    if (cadenceRpm >= breakpoints[Config::PAS_CADENCE_POINTS - 1]) {
+        col0 = col1 = Config::PAS_CADENCE_POINTS - 1;
+    } else if (cadenceRpm > breakpoints[0]) {
+        for (int i = 0; i < Config::PAS_CADENCE_POINTS - 1; ++i) {
+            const float span = breakpoints[i + 1] - breakpoints[i];
+            if (cadenceRpm < breakpoints[i + 1] && span > 0.0f) {
+                col0 = i;
+                col1 = i + 1;
+                colWeight = (cadenceRpm - breakpoints[i]) / span;
+                break;
+            }
+        }
+    }
+
+    const float low = config.pasAssistMap[row0][col0] + colWeight * (config.pasAssistMap[row0][col1] - config.pasAssistMap[row0][col0]);
+    const float high = config.pasAssistMap[row1][col0] + colWeight * (config.pasAssistMap[row1][col1] - config.pasAssistMap[row1][col0]);
+    return constrain(low + rowWeight * (high - low), 0.0f, 1.0f);
+}
+
 static int clampPasLevel(int level) {
     return constrain(level, 0, PAS_MAX_LEVEL);
 }
 
 static bool pedalsAreMoving() {
-    noInterrupts();
-    const uint32_t lastPulseMicrosSnapshot = lastPasPulseMicros;
-    const uint32_t pulseCountSnapshot = pasPulseCount;
-    interrupts();
-
-    if (pulseCountSnapshot == 0 || lastPulseMicrosSnapshot == 0) {
-        return false;
-    }
-
-    const uint32_t nowMicros = micros();
-    const uint32_t elapsed = nowMicros - lastPulseMicrosSnapshot;
-    return elapsed <= PAS_ACTIVITY_TIMEOUT_US;
+    return estimatePasCadence() > 0.0f;
 }
 
-static int CalculateMotorPowerSpeed(float targetMph) {
+// Open-loop demand (0..1) that would hold targetMph on flat ground
+static float CalculateMotorPowerSpeed(float targetMph) {
     const float mphPerRpm = wheelFactorMphPerRpm();
     if (mphPerRpm <= 0.0f || config.maxMotorRPM <= 0.0f) {
-        return 0;
+        return 0.0f;
     }
 
     const float targetRPM = targetMph / mphPerRpm;
-    const float pwmRatio = constrain(targetRPM / config.maxMotorRPM, 0.0f, 1.0f);
-    const int pwmValue = static_cast<int>(roundf(pwmRatio * ((1 << 16) - 1)));
-
-    return pwmValue;
+    return constrain(targetRPM / config.maxMotorRPM, 0.0f, 1.0f);
 }
 static int CalculateMotorPowerPAS(Motor& m) {
     const float mphPerRpm = wheelFactorMphPerRpm();
     if (!m.isPASMode || mphPerRpm <= 0.0f || config.maxMotorRPM <= 0.0f) {
-        drv8353.send3PWMMotorSignal(0, 0, 0);
-        drv8353.setCoast(true);
-        uart.sendData("PAS_PEDAL_ACTIVE", "FALSE");
-        uart.sendData("PAS_PWM", "0");
-        uart.sendData("PAS_CADENCE_RPM", "0");
         m.pasCadenceRpm = 0.0f;
+        m.pasBackpedaling = false;
+        m.pasPedaling = false;
+        m.pasAssistRatio = 0.0f;
+        if (!bridgeClaimed) {
+            drv8353.send3PWMMotorSignal(0, 0, 0);
+            drv8353.setCoast(true);
+        }
         return 0;
     }
 
-    const bool pedaling = pedalsAreMoving();
-    uart.sendData("PAS_PEDAL_ACTIVE", pedaling ? "TRUE" : "FALSE");
+    // Cadence is tracked every cycle so telemetry and the throttle-back check stay current
+    const float cadence = updatePasCadence(m);
+    m.pasPedaling = cadence > 0.0f;
+    m.pasAssistRatio = m.pasPedaling ? evaluateAssistMap(static_cast<float>(m.pasLevel), cadence) : 0.0f;
+
+    if (bridgeClaimed) {
+        return 0;  // Brake, throttle or cruise owns the bridge this cycle
+    }
+    bridgeClaimed = true;
 
-    if (!pedaling) {
+    if (!m.pasPedaling) {
         drv8353.send3PWMMotorSignal(0, 0, 0);
         drv8353.setCoast(true);
-        m.pasCadenceRpm = 0.0f;
-        uart.sendData("PAS_PWM", "0");
-        uart.sendData("PAS_CADENCE_RPM", "0");
         return 0;
     }
 
-    const float assistRatio = PAS_ASSIST_RATIOS[m.pasLevel];
-    const float targetRPM = config.maxMotorRPM * assistRatio;
-    const float targetMph = targetRPM * mphPerRpm;
-
-    const int requestedPwm = CalculateMotorPowerSpeed(targetMph);
-    int pwmValue = applyPowerLimit(m, requestedPwm);
+    const float requestedAmps = m.pasAssistRatio * config.maxPhaseCurrentAmps;
+    int pwmValue = applyCurrentControl(m, requestedAmps);
+    m.driveSource = DriveSource::Pas;
     drv8353.setCoast(false);
-    drv8353.send3PWMMotorSignal(pwmValue, pwmValue, pwmValue);
-
-    const float cadence = updatePasCadence(m);
-    uart.sendData("PAS_LEVEL", String(m.pasLevel));
-    uart.sendData("PAS_ASSIST_RATIO", String(assistRatio, 2));
-    uart.sendData("PAS_CADENCE_RPM", String(cadence, 1));
-    uart.sendData("PAS_TARGET_RPM", String(targetRPM, 2));
-    uart.sendData("PAS_PWM_REQUEST", String(requestedPwm));
-    uart.sendData("PAS_PWM", String(pwmValue));
+    commutation.drive(pwmValue);
 
     return pwmValue;
 }
@@ -248,15 +470,453 @@ void Motor::BRAKE() {
     drv8353.send3PWMMotorSignal(0, 0, 0);
     drv8353.setBrake(true);
 }
+void Motor::applyRequests() {
+    bool enable;
+    if (cruiseRequest.take(enable)) {
+        isCruiseControl = enable;
+    }
+    float mph;
+    if (cruiseTargetRequest.take(mph)) {
+        targetMph = mph;
+    }
+    // PAS changes go through setPASMode so the level is clamped and disabling clears cadence state
+    if (pasModeRequest.take(enable)) {
+        setPASMode(enable ? max(pasLevel, 1) : 0);
+    }
+    int level;
+    if (pasLevelRequest.take(level)) {
+        setPASMode(clampPasLevel(level));
+    }
+    if (coastRequested) {
+        coastRequested = false;
+        COAST();
+    }
+    if (brakeRequested) {
+        brakeRequested = false;
+        BRAKE();
+    }
+}
+void Motor::updateFaultTrip() {
+    // The lever trips the bridge in hardware unless regen is braking through it right now
+    phasePwm.armBrakeTrip(!regenEngaged);
+
+    if (faultClearRequested) {
+        faultClearRequested = false;
+        drv8353.clearFault();
+        if (!phasePwm.clearDriverFaultTrip()) {
+            uart.sendData("CLEAR_FAULT", "NFAULT_ACTIVE");
+        }
+    }
+
+    const PwmTrip trip = phasePwm.trip();
+    if (trip == lastPwmTrip) {
+        return;
+    }
+    lastPwmTrip = trip;
+    switch (trip) {
+        case PwmTrip::None: uart.sendData("PWM_TRIP", "NONE"); break;
+        case PwmTrip::DriverFault: uart.sendData("PWM_TRIP", "NFAULT"); break;
+        case PwmTrip::Brake: uart.sendData("PWM_TRIP", "BRAKE"); break;
+        case PwmTrip::Deadline: uart.sendData("PWM_TRIP", "DEADLINE"); break;
+    }
+    if (trip == PwmTrip::None) {
+        // The loops kept running open-circuit while tripped; drop them so the next command re-engages
+        currentLoop.reset();
+        currentLoopEngaged = false;
+        dutyCommand = 0.0f;
+        throttleShaper.reset();
+    }
+}
+static void resetTrackingStats(TrackingStats& stats) {
+    stats.sumSquares = 0.0f;
+    stats.sumAbs = 0.0f;
+    stats.maxAbs = 0.0f;
+    stats.samples = 0;
+    stats.windowStartMillis = millis();
+}
+
+static void updateTrackingStats(Motor& m, float errorMph) {
+    const float absError = fabsf(errorMph);
+    cruiseStats.sumSquares += errorMph * errorMph;
+    cruiseStats.sumAbs += absError;
+    cruiseStats.maxAbs = max(cruiseStats.maxAbs, absError);
+    cruiseStats.samples++;
+
+    if (millis() - cruiseStats.windowStartMillis < CRUISE_STATS_WINDOW_MS) {
+        return;
+    }
+
+    m.cruiseErrorRmsMph = sqrtf(cruiseStats.sumSquares / cruiseStats.samples);
+    m.cruiseErrorMeanAbsMph = cruiseStats.sumAbs / cruiseStats.samples;
+    m.cruiseErrorMaxMph = cruiseStats.maxAbs;
+    uart.sendData("CRUISE_ERROR_RMS_MPH", m.cruiseErrorRmsMph, 2);
+    uart.sendData("CRUISE_ERROR_MEAN_ABS_MPH", m.cruiseErrorMeanAbsMph, 2);
+    uart.sendData("CRUISE_ERROR_MAX_MPH", m.cruiseErrorMaxMph, 2);
+    resetTrackingStats(cruiseStats);
+}
+
 void Motor::updateCruiseControl() {
-    if (isCruiseControl) {
-        drv8353.setCoast(false);
-        int requestedPwm = CalculateMotorPowerSpeed(targetMph);
-        int pwmValue = applyPowerLimit(*this, requestedPwm);
-        drv8353.send3PWMMotorSignal(pwmValue, pwmValue, pwmValue);
-        uart.sendData("CRUISE_CONTROL_TARGET", String(targetMph));
-        uart.sendData("CRUISE_PWM_REQUEST", String(requestedPwm));
-        uart.sendData("CRUISE_PWM", String(pwmValue));
+    if (isCalibrating) {
+        return;
+    }
+    if (!isCruiseControl || bridgeClaimed) {
+        cruiseEngaged = false;  // Re-engage bumplessly once the bridge is ours again
+        return;
+    }
+
+    const float mphPerRpm = wheelFactorMphPerRpm();
+    if (mphPerRpm <= 0.0f) {
+        return;
+    }
+
+    const uint32_t nowMicros = micros();
+    float dtSec = (nowMicros - lastCruiseMicros) * 1e-6f;
+    lastCruiseMicros = nowMicros;
+
+    const float feedForwardAmps = CalculateMotorPowerSpeed(targetMph) * config.maxPhaseCurrentAmps;
+    speedLoop.kp = config.cruiseSpeedKp;
+    speedLoop.ki = config.cruiseSpeedKi;
+    speedLoop.outputMin = 0.0f;
+    speedLoop.outputMax = config.maxPhaseCurrentAmps;
+
+    if (!cruiseEngaged || dtSec > MAX_CONTROL_DT_SEC) {
+        // Bumpless transfer: continue from whatever current throttle or PAS was commanding
+        speedLoop.reset(currentSetpointAmps, feedForwardAmps);
+        resetTrackingStats(cruiseStats);
+        cruiseEngaged = true;
+        dtSec = 0.0f;
+    }
+
+    const float errorRpm = targetMph / mphPerRpm - rpm;
+    const float requestedAmps = speedLoop.update(errorRpm, dtSec, feedForwardAmps);
+    updateTrackingStats(*this, errorRpm * mphPerRpm);
+
+    bridgeClaimed = true;
+    drv8353.setCoast(false);
+    int pwmValue = applyCurrentControl(*this, requestedAmps);
+    driveSource = DriveSource::Cruise;
+    commutation.drive(pwmValue);
+}
+
+static bool motorIsIdle(const Motor& m) {
+    return !m.isCruiseControl && m.throttleFilteredRatio <= 0.0f && m.rpm < 1.0f && !pedalsAreMoving();
+}
+
+void Motor::calibrateCurrentSense() {
+    if (!adc.ready()) {
+        uart.sendData("CSA_CAL", "NO_ADC");  // Averaging 0 V readings would store 0 V offsets
+        lastCurrentSenseCalMillis = millis();
+        return;
+    }
+    deadlineMonitor.excuseCycle();  // Waits on ADC frames for far longer than one cycle, bridge off
+    COAST();
+    drv8353.setAutoCalibrationMode(false);
+    drv8353.calibrateSenseAmps(true);
+    delayMicroseconds(CSA_CAL_SETTLE_US);
+
+    // Every snapshot holds all three phases from the same DMA frame
+    const int samples = max(config.currentSenseCalSamples, 1);
+    float sums[3] = {0.0f, 0.0f, 0.0f};
+    uint32_t lastSequence = adc.snapshot().sequence;
+    bool timedOut = false;
+    for (int i = 0; i < samples && !timedOut; ++i) {
+        const uint32_t waitStart = millis();
+        AdcSnapshot frame = adc.snapshot();
+        while (frame.sequence == lastSequence && !timedOut) {
+            delay(1);
+            deadlineMonitor.feedWatchdog();
+            frame = adc.snapshot();
+            timedOut = millis() - waitStart > CSA_CAL_FRAME_TIMEOUT_MS;
+        }
+        lastSequence = frame.sequence;
+        for (int phase = 0; phase < 3; ++phase) {
+            sums[phase] += frame.volts[SENSE_A_CHANNEL + phase];
+        }
+    }
+
+    drv8353.calibrateSenseAmps(false);
+    drv8353.setAutoCalibrationMode(true);
+    lastCurrentSenseCalMillis = millis();
+
+    if (timedOut) {
+        uart.sendData("CSA_CAL", "TIMEOUT");
+        return;
+    }
+
+    for (int phase = 0; phase < 3; ++phase) {
+        config.currentSenseOffsetVolt[phase] = sums[phase] / samples;
+    }
+
+    uart.sendData("CSA_OFFSET_A", config.currentSenseOffsetVolt[0], 4);
+    uart.sendData("CSA_OFFSET_B", config.currentSenseOffsetVolt[1], 4);
+    uart.sendData("CSA_OFFSET_C", config.currentSenseOffsetVolt[2], 4);
+}
+
+// Canonical 120-degree hall order; learning checks the observed order against it
+static const uint8_t HALL_GRAY_SEQUENCE[6] = {1, 3, 2, 6, 4, 5};
+constexpr uint32_t HALL_LEARN_SAMPLE_MS = 10;
+
+static int hallSequenceIndex(uint8_t code) {
+    for (int i = 0; i < 6; ++i) {
+        if (HALL_GRAY_SEQUENCE[i] == code) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// Hold one step and wait for the rotor to settle, watching the current; returns the hall code or 0xFF on overcurrent
+static uint8_t alignToStep(uint8_t step) {
+    const uint16_t pwm = static_cast<uint16_t>(roundf(constrain(config.hallLearnDuty, 0.0f, 1.0f) * PWM_MAX));
+    commutation.driveSector(step, pwm);
+    const uint32_t start = millis();
+    while (millis() - start < config.hallLearnSettleMs) {
+        delay(HALL_LEARN_SAMPLE_MS);
+        deadlineMonitor.feedWatchdog();  // Learning holds the control task for seconds
+        if (readAveragePhaseCurrentMagnitude() > config.hallLearnMaxAmps) {
+            return Commutation::INVALID_SECTOR;
+        }
+    }
+    return HallInputs::read();
+}
+
+static const char* learnHallCodes(uint8_t codes[6]) {
+    const int cycles = max(config.hallLearnCycles, 1);
+    for (int cycle = 0; cycle < cycles; ++cycle) {
+        for (uint8_t step = 0; step < 6; ++step) {
+            const uint8_t code = alignToStep(step);
+            if (code == Commutation::INVALID_SECTOR) {
+                return "OVERCURRENT";
+            }
+            if (code == 0 || code == 7) {
+                return "INVALID_CODE";
+            }
+            if (cycle > 0 && codes[step] != code) {
+                return "INCONSISTENT";
+            }
+            codes[step] = code;
+        }
+    }
+
+    for (int i = 0; i < 6; ++i) {
+        for (int j = i + 1; j < 6; ++j) {
+            if (codes[i] == codes[j]) {
+                return "DUPLICATE_CODE";
+            }
+        }
+    }
+    return nullptr;
+}
+
+void Motor::learnHalls() {
+    deadlineMonitor.excuseCycle();  // Holds each step for hallLearnSettleMs
+    isCalibrating = true;
+    isCruiseControl = false;
+    drv8353.setBrake(false);
+    drv8353.setCoast(false);
+
+    uint8_t codes[6] = {0, 0, 0, 0, 0, 0};
+    const char* error = learnHallCodes(codes);
+    COAST();
+    isCalibrating = false;
+
+    if (error != nullptr) {
+        uart.sendData("HALL_LEARN", error);
+        return;
+    }
+
+    // The rotor settles on the field of the held step, so lead it by one step to produce torque
+    for (int code = 0; code < 8; ++code) {
+        config.hallSectorTable[code] = Commutation::INVALID_SECTOR;
+    }
+    for (uint8_t step = 0; step < 6; ++step) {
+        config.hallSectorTable[codes[step]] = (step + 1) % 6;
+    }
+
+    const int first = hallSequenceIndex(codes[0]);
+    const int second = hallSequenceIndex(codes[1]);
+    config.hallSequenceForward = (first + 1) % 6 == second;
+    configStore.publish();
+
+    FixedString<32> table;
+    for (int code = 0; code < 8; ++code) {
+        table.appendf("%d", config.hallSectorTable[code] == Commutation::INVALID_SECTOR ? -1 : config.hallSectorTable[code]);
+        table.append(code < 7 ? "," : "");
+    }
+    uart.sendData("HALL_SECTOR_TABLE", table.c_str());
+    uart.sendData("HALL_DIRECTION", config.hallSequenceForward ? "FORWARD" : "REVERSE");
+    uart.sendData("HALL_LEARN", "OK");
+}
+
+static uint32_t revolutionStartEdges = 0;
+static bool revolutionCountActive = false;
+
+void Motor::startHallRevolutionCount() {
+    COAST();
+    revolutionStartEdges = pulseCounter.hallEdges();
+    revolutionCountActive = true;
+    uart.sendData("HALL_REV_COUNT", "STARTED");
+}
+
+void Motor::finishHallRevolutionCount() {
+    if (!revolutionCountActive) {
+        uart.sendData("HALL_REV_COUNT", "NOT_STARTED");
+        return;
+    }
+    revolutionCountActive = false;
+
+    // Edges per revolution is always six per pole pair; round off a slightly over- or under-turned wheel
+    const uint32_t edges = pulseCounter.hallEdges() - revolutionStartEdges;
+    const int polePairs = static_cast<int>(roundf(edges / 6.0f));
+    uart.sendData("HALL_REV_EDGES", edges);
+    if (polePairs <= 0) {
+        uart.sendData("HALL_REV_COUNT", "NO_EDGES");
+        return;
+    }
+    config.hallEdgesPerRev = polePairs * 6;
+    configStore.publish();
+    uart.sendData("HALL_EDGES_PER_REV", config.hallEdgesPerRev);
+    uart.sendData("HALL_REV_COUNT", "OK");
+}
+
+void Motor::updateHallLearning() {
+    if (hallRevStartRequested) {
+        hallRevStartRequested = false;
+        startHallRevolutionCount();
+    }
+    if (hallRevStopRequested) {
+        hallRevStopRequested = false;
+        finishHallRevolutionCount();
+    }
+    if (hallLearnRequested) {
+        hallLearnRequested = false;
+        learnHalls();
+    }
+}
+
+void Motor::updateCurrentSenseCalibration() {
+    if (isCalibrating) {
+        return;
+    }
+    if (currentSenseCalRequested) {
+        currentSenseCalRequested = false;
+        calibrateCurrentSense();
+        configStore.publish();
+        return;
+    }
+    if (config.currentSenseRecalIntervalMs == 0) {
+        return;
+    }
+    if (millis() - lastCurrentSenseCalMillis < config.currentSenseRecalIntervalMs) {
+        return;
+    }
+    if (!motorIsIdle(*this)) {
+        return;
+    }
+    calibrateCurrentSense();
+    configStore.publish();
+}
+
+void Motor::publishState() {
+    MotorState next;
+    next.rpm = rpm;
+    next.mph = mph;
+    next.isCruiseControl = isCruiseControl;
+    next.targetMph = targetMph;
+    next.cruiseErrorRmsMph = cruiseErrorRmsMph;
+    next.cruiseErrorMeanAbsMph = cruiseErrorMeanAbsMph;
+    next.cruiseErrorMaxMph = cruiseErrorMaxMph;
+    next.isPASMode = isPASMode;
+    next.pasLevel = pasLevel;
+    next.pasCadenceRpm = pasCadenceRpm;
+    next.pasBackpedaling = pasBackpedaling;
+    next.busVoltage = battery.getBatteryVoltage();
+    next.lastBusVoltage = lastBusVoltage;
+    next.lastPhaseCurrent = lastPhaseCurrent;
+    next.lastElectricalPower = lastElectricalPower;
+    next.currentSetpointAmps = currentSetpointAmps;
+    next.dutyCommand = dutyCommand;
+    next.throttleFilteredRatio = throttleFilteredRatio;
+    next.commutationMode = static_cast<uint8_t>(commutation.mode());
+    next.hallState = commutation.hallState();
+    next.hallErrors = commutation.hallErrors();
+    next.whPerMileHall = commutation.whPerMile(CommutationMode::Hall);
+    next.whPerMileSensorless = commutation.whPerMile(CommutationMode::Sensorless);
+    next.brakeActive = brakeActive;
+    next.throttleVoltage = throttleVoltage;
+    next.driveSource = driveSource;
+    next.currentRequestAmps = currentRequestAmps;
+    next.drivePwm = drivePwm;
+    next.currentLimitActive = currentLimitActive;
+    next.pasAssistRatio = pasAssistRatio;
+    next.pasPedaling = pasPedaling;
+    next.pasPulseCount = pulseCounter.pasPulses();
+    for (int phase = 0; phase < 3; ++phase) {
+        next.phaseDuty[phase] = phasePwm.duty(phase);
+    }
+    published.write(next);
+}
+
+static const char* boolText(bool value) {
+    return value ? "TRUE" : "FALSE";
+}
+
+// PWM of one drive path, zero while another path (or none) holds the bridge
+static long sourcePwm(const MotorState& state, DriveSource source) {
+    return state.driveSource == source ? state.drivePwm : 0;
+}
+
+void Motor::reportState() const {
+    const MotorState s = state();
+    telemetry.sample("MOTOR_RPM", s.rpm, 2);
+    telemetry.sample("MOTOR_SPEED_MPH", s.mph, 2);
+    telemetry.sample("COMMUTATION_WH_PER_MILE_HALL", s.whPerMileHall, 1);
+    telemetry.sample("COMMUTATION_WH_PER_MILE_SENSORLESS", s.whPerMileSensorless, 1);
+    telemetry.sample("MOTOR_BUS_VOLT", s.lastBusVoltage, 2);
+    telemetry.sample("MOTOR_PHASE_CURRENT", s.lastPhaseCurrent, 2);
+    telemetry.sample("MOTOR_POWER_W", s.lastElectricalPower, 1);
+    telemetry.sample("MOTOR_CURRENT_SETPOINT", s.currentSetpointAmps, 2);
+
+    FixedString<32> pwm;
+    pwm.appendf("A:%u B:%u C:%u", s.phaseDuty[0], s.phaseDuty[1], s.phaseDuty[2]);
+    telemetry.sample("MOTOR_PWM", pwm.c_str());
+
+    const bool regen = s.driveSource == DriveSource::Regen;
+    telemetry.sample("MOTOR_POWER_LIMIT_ACTIVE", boolText(s.currentLimitActive && !regen));
+    if (s.currentLimitActive && !regen) {
+        telemetry.sample("MOTOR_POWER_LIMIT_PWM", static_cast<long>(s.drivePwm));
+    }
+    telemetry.sample("REGEN_LIMIT_ACTIVE", boolText(s.currentLimitActive && regen));
+    telemetry.sample("REGEN_PWM", sourcePwm(s, DriveSource::Regen));
+
+    telemetry.sample("BRAKE_ACTIVE", boolText(s.brakeActive));
+    telemetry.sample("THROTTLE_VOLT", s.throttleVoltage, 2);
+    telemetry.sample("THROTTLE_RATIO", s.throttleFilteredRatio, 3);
+    telemetry.sample("THROTTLE_PWM", sourcePwm(s, DriveSource::Throttle));
+
+    telemetry.sample("PAS_LEVEL", static_cast<long>(s.pasLevel));
+    telemetry.sample("PAS_PEDAL_ACTIVE", boolText(s.pasPedaling));
+    telemetry.sample("PAS_BACKPEDAL", boolText(s.pasBackpedaling));
+    telemetry.sample("PAS_CADENCE_RPM", s.pasCadenceRpm, 1);
+    telemetry.sample("PAS_ASSIST_RATIO", s.pasAssistRatio, 2);
+    telemetry.sample("PAS_PULSE_COUNT", static_cast<unsigned long>(s.pasPulseCount));
+    telemetry.sample("PAS_PWM", sourcePwm(s, DriveSource::Pas));
+
+    if (s.isCruiseControl) {
+        telemetry.sample("CRUISE_CONTROL_TARGET", s.targetMph, 2);
+    }
+    telemetry.sample("CRUISE_PWM", sourcePwm(s, DriveSource::Cruise));
+
+    const char* requestName = nullptr;
+    switch (s.driveSource) {
+        case DriveSource::Throttle: requestName = "THROTTLE_CURRENT_REQUEST"; break;
+        case DriveSource::Pas: requestName = "PAS_CURRENT_REQUEST"; break;
+        case DriveSource::Cruise: requestName = "CRUISE_CURRENT_REQUEST"; break;
+        case DriveSource::Regen: requestName = "REGEN_CURRENT_REQUEST"; break;
+        case DriveSource::None: break;
+    }
+    if (requestName != nullptr) {
+        telemetry.sample(requestName, s.currentRequestAmps, 2);
     }
 }
 
@@ -265,45 +925,54 @@ void Motor::setPASMode(int mode) {
     isPASMode = pasLevel > 0;
 
     uart.sendData("PAS_MODE_ENABLED", isPASMode ? "TRUE" : "FALSE");
-    uart.sendData("PAS_LEVEL", String(pasLevel));
-    uart.sendData("PAS_ASSIST_RATIO", String(PAS_ASSIST_RATIOS[pasLevel], 2));
+    uart.sendData("PAS_LEVEL", pasLevel);
+    uart.sendData("PAS_ASSIST_RATIO", evaluateAssistMap(static_cast<float>(pasLevel), pasCadenceRpm), 2);
 
     if (!isPASMode) {
         noInterrupts();
-        pasPulseCount = 0;
         lastPasPulseMicros = 0;
+        pasPeriodCount = 0;
+        pasBackpedal = false;
         interrupts();
-    pasCadenceRpm = 0.0f;
+        pasCadenceRpm = 0.0f;
+        pasBackpedaling = false;
+        pasPedaling = false;
+        pasAssistRatio = 0.0f;
         drv8353.send3PWMMotorSignal(0, 0, 0);
         drv8353.setCoast(true);
-        uart.sendData("PAS_PEDAL_ACTIVE", "FALSE");
-        uart.sendData("PAS_PWM", "0");
-        uart.sendData("PAS_CADENCE_RPM", "0");
     }
 }
 
 void Motor::updatePASControl() {
-    if (isPASMode) {
+    if (isPASMode && !isCalibrating) {
         CalculateMotorPowerPAS(*this);
     }
 }
 
 void Motor::updateThrottleControl() {
-    const bool brakeActive = digitalRead(Pins::SENSOR_BRAKE_SIGNAL.pin) == LOW;
-    uart.sendData("BRAKE_ACTIVE", brakeActive ? "TRUE" : "FALSE");
+    if (isCalibrating) {
+        return;
+    }
+    brakeActive = !BrakeInput::read();
 
     if (brakeActive) {
+        bridgeClaimed = true;
         isCruiseControl = false;
         throttleFilteredRatio = 0.0f;
-        drv8353.send3PWMMotorSignal(0, 0, 0);
-        drv8353.setCoast(true);
-        uart.sendData("THROTTLE_RATIO", "0");
-        uart.sendData("THROTTLE_PWM", "0");
+        throttleShaper.reset();
+        lastThrottleMicros = 0;
+
+        const int regenPwm = applyRegenControl(*this, config.regenBrakeAmps);
+        if (regenPwm >= 0) {
+            drv8353.setCoast(false);
+            commutation.drive(regenPwm);
+        } else {
+            coastBridge(*this);
+        }
         return;
     }
 
-    const float throttleVoltage = readAdcVoltage(Pins::SENSOR_THROTTLE_DATA);
-    uart.sendData("THROTTLE_VOLT", String(throttleVoltage, 2));
+    throttleVoltage = inputs.volts[static_cast<int>(AdcChannel::Throttle)];
 
     const float vMin = config.throttleMinVoltage;
     const float vMax = config.throttleMaxVoltage;
@@ -317,26 +986,39 @@ void Motor::updateThrottleControl() {
         rawRatio = 0.0f;
     }
 
-    const float alpha = constrain(config.throttleFilterAlpha, 0.0f, 1.0f);
-    throttleFilteredRatio += alpha * (rawRatio - throttleFilteredRatio);
+    const uint32_t nowMicros = micros();
+    const float dtSec = lastThrottleMicros == 0 ? 0.0f : min((nowMicros - lastThrottleMicros) * 1e-6f, MAX_CONTROL_DT_SEC);
+    lastThrottleMicros = nowMicros;
+    throttleFilteredRatio = throttleShaper.update(rawRatio, dtSec);
 
     if (throttleFilteredRatio < 0.001f) {
         throttleFilteredRatio = 0.0f;
-        uart.sendData("THROTTLE_RATIO", "0");
-        uart.sendData("THROTTLE_PWM", "0");
+
+        // Throttle-back zone: light regen while rolling with no other drive source active
+        if (!isCruiseControl && !(isPASMode && pedalsAreMoving())) {
+            bridgeClaimed = true;
+            const int regenPwm = applyRegenControl(*this, config.regenThrottleBackAmps);
+            if (regenPwm >= 0) {
+                drv8353.setCoast(false);
+                commutation.drive(regenPwm);
+            } else {
+                coastBridge(*this);
+            }
+        } else {
+            releaseRegen();
+        }
         return;
     }
 
-    uart.sendData("THROTTLE_RATIO", String(throttleFilteredRatio, 3));
+    releaseRegen();
 
+    bridgeClaimed = true;
     isCruiseControl = false;
 
-    const int requestedPwm = static_cast<int>(roundf(throttleFilteredRatio * ((1 << 16) - 1)));
-    int pwmValue = applyPowerLimit(*this, requestedPwm);
+    const float requestedAmps = throttleFilteredRatio * config.maxPhaseCurrentAmps;
+    int pwmValue = applyCurrentControl(*this, requestedAmps);
+    driveSource = DriveSource::Throttle;
 
     drv8353.setCoast(false);
-    drv8353.send3PWMMotorSignal(pwmValue, pwmValue, pwmValue);
-
-    uart.sendData("THROTTLE_PWM_REQUEST", String(requestedPwm));
-    uart.sendData("THROTTLE_PWM", String(pwmValue));
+    commutation.drive(pwmValue);
 }
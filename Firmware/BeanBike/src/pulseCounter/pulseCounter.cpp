@@ -0,0 +1,94 @@
+#include <Arduino.h>
+#include <driver/pcnt.h>
+#include "pulseCounter.h"
+#include "globals.h"
+
+constexpr pcnt_unit_t HALL_AB_UNIT = PCNT_UNIT_0; // Hall A on channel 0, hall B on channel 1
+constexpr pcnt_unit_t HALL_C_UNIT = PCNT_UNIT_1;
+constexpr pcnt_unit_t PAS_UNIT = PCNT_UNIT_2;
+constexpr pcnt_unit_t UNITS[3] = {HALL_AB_UNIT, HALL_C_UNIT, PAS_UNIT};
+constexpr uint32_t APB_CYCLES_PER_US = 80;
+constexpr uint16_t PCNT_FILTER_MAX = 1023;
+
+static uint16_t filterCycles(float microseconds) {
+    const float cycles = microseconds * APB_CYCLES_PER_US;
+    return static_cast<uint16_t>(constrain(cycles, 0.0f, static_cast<float>(PCNT_FILTER_MAX)));
+}
+
+static void configureChannel(pcnt_unit_t unit, pcnt_channel_t channel, int pulsePin, int ctrlPin,
+                             pcnt_count_mode_t risingMode, pcnt_count_mode_t fallingMode,
+                             pcnt_ctrl_mode_t ctrlHighMode) {
+    pcnt_config_t cfg = {};
+    cfg.pulse_gpio_num = pulsePin;
+    cfg.ctrl_gpio_num = ctrlPin;
+    cfg.pos_mode = risingMode;
+    cfg.neg_mode = fallingMode;
+    cfg.lctrl_mode = PCNT_MODE_KEEP;
+    cfg.hctrl_mode = ctrlHighMode;
+    cfg.counter_h_lim = PulseCounter::COUNT_LIMIT;
+    cfg.counter_l_lim = -PulseCounter::COUNT_LIMIT;
+    cfg.unit = unit;
+    cfg.channel = channel;
+    pcnt_unit_config(&cfg);
+}
+
+static void startUnit(pcnt_unit_t unit, uint16_t filter) {
+    if (filter > 0) {
+        pcnt_set_filter_value(unit, filter);
+        pcnt_filter_enable(unit);
+    } else {
+        pcnt_filter_disable(unit);
+    }
+    pcnt_counter_pause(unit);
+    pcnt_counter_clear(unit);
+    pcnt_counter_resume(unit);
+}
+
+// The counters reset to zero at either limit, so the raw value is the true count modulo COUNT_LIMIT
+static int32_t wrappedDelta(int16_t now, int16_t last) {
+    int32_t delta = (static_cast<int32_t>(now) - last) % PulseCounter::COUNT_LIMIT;
+    if (delta > PulseCounter::COUNT_LIMIT / 2) {
+        delta -= PulseCounter::COUNT_LIMIT;
+    } else if (delta < -PulseCounter::COUNT_LIMIT / 2) {
+        delta += PulseCounter::COUNT_LIMIT;
+    }
+    return delta;
+}
+
+void PulseCounter::init() {
+    const uint16_t hallFilter = filterCycles(config.hallGlitchFilterUs);
+    const uint16_t pasFilter = filterCycles(config.pasGlitchFilterUs);
+
+    configureChannel(HALL_AB_UNIT, PCNT_CHANNEL_0, Pins::MOTOR_HALL_A.pin, PCNT_PIN_NOT_USED,
+                     PCNT_COUNT_INC, PCNT_COUNT_INC, PCNT_MODE_KEEP);
+    configureChannel(HALL_AB_UNIT, PCNT_CHANNEL_1, Pins::MOTOR_HALL_B.pin, PCNT_PIN_NOT_USED,
+                     PCNT_COUNT_INC, PCNT_COUNT_INC, PCNT_MODE_KEEP);
+    configureChannel(HALL_C_UNIT, PCNT_CHANNEL_0, Pins::MOTOR_HALL_C.pin, PCNT_PIN_NOT_USED,
+                     PCNT_COUNT_INC, PCNT_COUNT_INC, PCNT_MODE_KEEP);
+
+    // Quadrature sensors count down while channel B reads as reverse
+    const int dirPin = config.pasQuadrature ? Pins::SENSOR_PAS_DIR.pin : PCNT_PIN_NOT_USED;
+    const pcnt_count_mode_t forward = config.pasDirectionInverted ? PCNT_COUNT_DEC : PCNT_COUNT_INC;
+    configureChannel(PAS_UNIT, PCNT_CHANNEL_0, Pins::SENSOR_PAS_PULSE.pin, dirPin,
+                     forward, PCNT_COUNT_DIS, PCNT_MODE_REVERSE);
+
+    startUnit(HALL_AB_UNIT, hallFilter);
+    startUnit(HALL_C_UNIT, hallFilter);
+    startUnit(PAS_UNIT, pasFilter);
+
+    uart.sendData("PCNT_HALL_FILTER_CYCLES", hallFilter);
+    uart.sendData("PCNT_PAS_FILTER_CYCLES", pasFilter);
+}
+
+void PulseCounter::poll() {
+    int32_t deltas[3];
+    for (int i = 0; i < 3; ++i) {
+        int16_t raw = 0;
+        pcnt_get_counter_value(UNITS[i], &raw);
+        deltas[i] = wrappedDelta(raw, lastRaw[i]);
+        lastRaw[i] = raw;
+    }
+
+    hallEdgeTotal += static_cast<uint32_t>(deltas[0] + deltas[1]);
+    pasPulseTotal += deltas[2];
+}
@@ -0,0 +1,199 @@
+#include <Arduino.h>
+#include <driver/mcpwm.h>
+#include <soc/mcpwm_struct.h>
+#include "phasePwm.h"
+#include "globals.h"
+
+constexpr mcpwm_unit_t PWM_UNIT = MCPWM_UNIT_0;
+constexpr mcpwm_timer_t PHASE_TIMERS[3] = {MCPWM_TIMER_0, MCPWM_TIMER_1, MCPWM_TIMER_2};
+constexpr uint32_t PWM_RESOLUTION_HZ = 80000000;  // Group and timer clock; also the dead-time tick
+constexpr uint32_t COMPARE_UPDATE_ON_TEZ = 1;     // Shadow -> active when the counter reaches zero
+constexpr mcpwm_fault_signal_t DRIVER_FAULT_SIGNAL = MCPWM_SELECT_F0;  // nFAULT, active low
+constexpr mcpwm_fault_signal_t BRAKE_FAULT_SIGNAL = MCPWM_SELECT_F1;   // Brake lever, active low
+
+static portMUX_TYPE pwmLock = portMUX_INITIALIZER_UNLOCKED;
+
+// Both generators forced low is Hi-Z on every phase, whatever the dead-time stage is doing
+static void latchDriverFault(mcpwm_timer_t timer) {
+    mcpwm_fault_set_oneshot_mode(PWM_UNIT, timer, DRIVER_FAULT_SIGNAL, MCPWM_ACTION_FORCE_LOW, MCPWM_ACTION_FORCE_LOW);
+}
+
+static uint32_t deadTimeTicks() {
+    const float ticks = config.pwmDeadTimeNs * (PWM_RESOLUTION_HZ / 1e9f);
+    return static_cast<uint32_t>(constrain(ticks, 0.0f, 1023.0f));
+}
+
+void PhasePwm::init() {
+    const struct { int high; int low; mcpwm_io_signals_t highSignal; mcpwm_io_signals_t lowSignal; } outputs[3] = {
+        {Pins::MOTOR_INHA.pin, Pins::MOTOR_INLA.pin, MCPWM0A, MCPWM0B},
+        {Pins::MOTOR_INHB.pin, Pins::MOTOR_INLB.pin, MCPWM1A, MCPWM1B},
+        {Pins::MOTOR_INHC.pin, Pins::MOTOR_INLC.pin, MCPWM2A, MCPWM2B},
+    };
+
+    mcpwm_group_set_resolution(PWM_UNIT, PWM_RESOLUTION_HZ);
+    for (int phase = 0; phase < 3; ++phase) {
+        const mcpwm_timer_t timer = PHASE_TIMERS[phase];
+        mcpwm_gpio_init(PWM_UNIT, outputs[phase].highSignal, outputs[phase].high);
+        mcpwm_gpio_init(PWM_UNIT, outputs[phase].lowSignal, outputs[phase].low);
+        mcpwm_timer_set_resolution(PWM_UNIT, timer, PWM_RESOLUTION_HZ);
+
+        mcpwm_config_t cfg = {};
+        cfg.frequency = config.pwmFrequencyHz;
+        cfg.cmpr_a = 0.0f;
+        cfg.cmpr_b = 0.0f;
+        cfg.duty_mode = MCPWM_DUTY_MODE_0;
+        cfg.counter_mode = MCPWM_UP_DOWN_COUNTER; // Center-aligned
+        mcpwm_init(PWM_UNIT, timer, &cfg);
+
+        // Duty writes go to the shadow register and load only at counter zero
+        MCPWM0.channel[phase].cmpr_cfg.a_upmethod = COMPARE_UPDATE_ON_TEZ;
+    }
+
+    // Timers 1 and 2 restart with timer 0 so all three carriers share one period boundary
+    mcpwm_set_timer_sync_output(PWM_UNIT, MCPWM_TIMER_0, MCPWM_SWSYNC_SOURCE_TEZ);
+    for (int phase = 1; phase < 3; ++phase) {
+        mcpwm_sync_config_t sync = {};
+        sync.sync_sig = MCPWM_SELECT_TIMER0_SYNC;
+        sync.timer_val = 0;
+        sync.count_direction = MCPWM_TIMER_DIRECTION_UP;
+        mcpwm_sync_configure(PWM_UNIT, PHASE_TIMERS[phase], &sync);
+    }
+
+    // nFAULT and the brake lever reach the trip zone through the GPIO matrix, so the outputs
+    // go off within a few PWM clocks with no interrupt or SPI transaction in the path
+    mcpwm_gpio_init(PWM_UNIT, MCPWM_FAULT_0, Pins::MOTOR_FAULT.pin);
+    mcpwm_gpio_init(PWM_UNIT, MCPWM_FAULT_1, Pins::SENSOR_BRAKE_SIGNAL.pin);
+    mcpwm_fault_init(PWM_UNIT, MCPWM_LOW_LEVEL_TGR, DRIVER_FAULT_SIGNAL);
+    mcpwm_fault_init(PWM_UNIT, MCPWM_LOW_LEVEL_TGR, BRAKE_FAULT_SIGNAL);
+    for (int phase = 0; phase < 3; ++phase) {
+        latchDriverFault(PHASE_TIMERS[phase]);
+        // force_ost is ignored unless software is enabled as a one-shot source
+        MCPWM0.channel[phase].tz_cfg0.sw_ost = 1;
+    }
+    // F1 stays a cycle-by-cycle source for good; arming only swaps its action
+    brakeTripArmed = false;
+    armBrakeTrip(true);
+
+    peakTicks = MCPWM0.timer[0].period.period;
+    floatingMask = 0;
+    setPhaseEnables(false, false, false);
+    setDuties(0, 0, 0);
+
+    uart.sendData("PWM_FREQUENCY_HZ", config.pwmFrequencyHz);
+    uart.sendData("PWM_DEADTIME_TICKS", deadTimeTicks());
+}
+
+void IRAM_ATTR PhasePwm::setDuties(uint16_t dutyA, uint16_t dutyB, uint16_t dutyC) {
+    duties[0] = dutyA;
+    duties[1] = dutyB;
+    duties[2] = dutyC;
+    uint32_t compare[3];
+    for (int phase = 0; phase < 3; ++phase) {
+        compare[phase] = static_cast<uint32_t>(duties[phase]) * peakTicks / DUTY_FULL;
+    }
+
+    // Hold the global shadow load off while writing so a zero crossing can never latch a
+    // mix of old and new duties; all three load together at the next period boundary
+    portENTER_CRITICAL_SAFE(&pwmLock);
+    MCPWM0.update_cfg.global_up_en = 0;
+    for (int phase = 0; phase < 3; ++phase) {
+        MCPWM0.channel[phase].cmpr_value[0].cmpr_val = compare[phase];
+    }
+    MCPWM0.update_cfg.global_up_en = 1;
+    portEXIT_CRITICAL_SAFE(&pwmLock);
+}
+
+void PhasePwm::setPhaseEnables(bool a, bool b, bool c) {
+    const uint8_t mask = static_cast<uint8_t>((a ? 0 : 1u) | (b ? 0 : 2u) | (c ? 0 : 4u));
+    const uint8_t changed = mask ^ floatingMask;
+    if (changed == 0) {
+        return;
+    }
+
+    for (int phase = 0; phase < 3; ++phase) {
+        const uint8_t bit = static_cast<uint8_t>(1u << phase);
+        if ((changed & bit) == 0) {
+            continue;
+        }
+        const mcpwm_timer_t timer = PHASE_TIMERS[phase];
+        if (mask & bit) {
+            // Bypass the dead-time stage so both generators can be held low: Hi-Z
+            mcpwm_deadtime_disable(PWM_UNIT, timer);
+            mcpwm_set_signal_low(PWM_UNIT, timer, MCPWM_GEN_A);
+            mcpwm_set_signal_low(PWM_UNIT, timer, MCPWM_GEN_B);
+        } else {
+            // INLx becomes the delayed complement of INHx
+            mcpwm_set_duty_type(PWM_UNIT, timer, MCPWM_GEN_A, MCPWM_DUTY_MODE_0);
+            mcpwm_deadtime_enable(PWM_UNIT, timer, MCPWM_ACTIVE_HIGH_COMPLIMENT_MODE, deadTimeTicks(), deadTimeTicks());
+        }
+    }
+    floatingMask = mask;
+}
+
+void PhasePwm::armBrakeTrip(bool armed) {
+    if (armed == brakeTripArmed) {
+        return;
+    }
+    // Never deinit F1: that would tear down the trip zone while a one-shot latch may be held.
+    // Changing the cycle-by-cycle action leaves the one-shot sources and their latch alone.
+    const mcpwm_output_action_t action = armed ? MCPWM_ACTION_FORCE_LOW : MCPWM_ACTION_NO_CHANGE;
+    for (int phase = 0; phase < 3; ++phase) {
+        mcpwm_fault_set_cyc_mode(PWM_UNIT, PHASE_TIMERS[phase], BRAKE_FAULT_SIGNAL, action, action);
+    }
+    brakeTripArmed = armed;
+    uart.sendData("PWM_BRAKE_TRIP", armed ? "ARMED" : "DISARMED");
+}
+
+static bool driverFaultAsserted() {
+    return !FaultInput::read();
+}
+
+// A rising edge on clr_ost releases the one-shot latch on every operator
+static void clearOneShotLatch() {
+    for (int phase = 0; phase < 3; ++phase) {
+        MCPWM0.channel[phase].tz_cfg1.clr_ost = 1;
+    }
+    for (int phase = 0; phase < 3; ++phase) {
+        MCPWM0.channel[phase].tz_cfg1.clr_ost = 0;
+    }
+}
+
+PwmTrip PhasePwm::trip() const {
+    // All three operators see the same fault signals; operator 0 speaks for them
+    if (MCPWM0.channel[0].tz_status.ost_on) {
+        return deadlineTripped && !driverFaultAsserted() ? PwmTrip::Deadline : PwmTrip::DriverFault;
+    }
+    // A disarmed brake still raises cbc_on, but with no action it has not tripped anything
+    if (brakeTripArmed && MCPWM0.channel[0].tz_status.cbc_on) {
+        return PwmTrip::Brake;
+    }
+    return PwmTrip::None;
+}
+
+bool PhasePwm::clearDriverFaultTrip() {
+    if (driverFaultAsserted()) {
+        return false;
+    }
+    clearOneShotLatch();
+    return true;
+}
+
+void PhasePwm::forceDeadlineTrip() {
+    deadlineTripped = true;
+    // A toggle of force_ost trips the operator exactly as an nFAULT edge would
+    for (int phase = 0; phase < 3; ++phase) {
+        MCPWM0.channel[phase].tz_cfg1.force_ost = 1;
+        MCPWM0.channel[phase].tz_cfg1.force_ost = 0;
+    }
+    // Zero duty as well, so releasing the latch never resumes the last command
+    setDuties(0, 0, 0);
+}
+
+bool PhasePwm::clearDeadlineTrip() {
+    if (driverFaultAsserted()) {
+        return false;
+    }
+    deadlineTripped = false;
+    clearOneShotLatch();
+    return true;
+}
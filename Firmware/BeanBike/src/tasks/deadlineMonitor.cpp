@@ -0,0 +1,97 @@
+#include <Arduino.h>
+#include <esp_task_wdt.h>
+#include "deadlineMonitor.h"
+#include "globals.h"
+
+constexpr uint64_t STALL_CHECK_PERIOD_US = 1000;
+
+void DeadlineMonitor::init() {
+    // Backstop for a hang the trip cannot fix: panic and reset, which releases every gate pin
+    esp_task_wdt_init(config.controlWatchdogTimeoutSec, true);
+    esp_task_wdt_add(nullptr);
+
+    esp_timer_create_args_t args = {};
+    args.callback = checkStall;
+    args.arg = this;
+    args.name = "DEADLINE";
+    if (esp_timer_create(&args, &stallTimer) == ESP_OK) {
+        esp_timer_start_periodic(stallTimer, STALL_CHECK_PERIOD_US);
+    }
+}
+
+void DeadlineMonitor::beginCycle() {
+    excused = false;
+    cycleStartMicros = micros();
+    inCycle = true;
+}
+
+void DeadlineMonitor::endCycle() {
+    const uint32_t elapsed = micros() - cycleStartMicros;
+    inCycle = false;
+    esp_task_wdt_reset();
+
+    if (excused) {
+        return;
+    }
+    if (elapsed > worstCycleMicros) {
+        worstCycleMicros = elapsed;
+    }
+
+    if (stallTripped || elapsed > config.controlCycleBudgetUs) {
+        overruns++;
+        onTimeCycles = 0;
+        if (consecutiveMisses < UINT8_MAX) {
+            consecutiveMisses++;
+        }
+        if (stallTripped || consecutiveMisses >= config.controlMaxMissedDeadlines) {
+            stallTripped = false;
+            trip();
+        }
+        return;
+    }
+
+    consecutiveMisses = 0;
+    if (!tripped) {
+        return;
+    }
+    if (++onTimeCycles >= config.controlRecoveryCycles && phasePwm.clearDeadlineTrip()) {
+        tripped = false;
+        uart.sendData("CONTROL_DEADLINE", "RECOVERED");
+    }
+}
+
+void DeadlineMonitor::feedWatchdog() {
+    esp_task_wdt_reset();
+}
+
+void DeadlineMonitor::trip() {
+    phasePwm.forceDeadlineTrip();
+    Motor::COAST();  // Control task: the DRV8353 COAST bit backs up the MCPWM latch
+    if (!tripped) {
+        tripped = true;
+        trips++;
+        uart.sendData("CONTROL_DEADLINE", "TRIPPED");
+    }
+    onTimeCycles = 0;
+}
+
+// esp_timer task, core 0: the control task is stuck in the middle of a cycle
+void DeadlineMonitor::checkStall(void* parameter) {
+    DeadlineMonitor* self = static_cast<DeadlineMonitor*>(parameter);
+    if (!self->inCycle || self->excused || self->stallTripped) {
+        return;
+    }
+    const uint32_t stallLimit = config.controlCycleBudgetUs * max<uint32_t>(config.controlMaxMissedDeadlines, 1);
+    if (micros() - self->cycleStartMicros > stallLimit) {
+        self->stallTripped = true;
+        phasePwm.forceDeadlineTrip(); // Output off now; endCycle does the bookkeeping if it ever returns
+    }
+}
+
+void DeadlineMonitor::report() {
+    const uint32_t worst = worstCycleMicros;
+    worstCycleMicros = 0;
+    uart.sendData("CONTROL_CYCLE_WORST_US", worst);
+    uart.sendData("CONTROL_OVERRUNS", overruns);
+    uart.sendData("CONTROL_DEADLINE_TRIPS", trips);
+}
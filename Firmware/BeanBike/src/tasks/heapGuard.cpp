@@ -0,0 +1,61 @@
+#include <Arduino.h>
+#include <esp_rom_sys.h>
+#include "heapGuard.h"
+#include "globals.h"
+
+#ifdef HEAP_GUARD
+
+extern "C" {
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t count, size_t size);
+void* __real_realloc(void* pointer, size_t size);
+}
+
+static TaskHandle_t watchedTask = nullptr;
+static volatile uint32_t allocationCount = 0;
+static volatile bool armed = false;
+
+static void noteAllocation(size_t size) {
+    if (watchedTask == nullptr || xPortInIsrContext() || xTaskGetCurrentTaskHandle() != watchedTask) {
+        return;
+    }
+    allocationCount++;
+    if (armed) {
+        // Abort here rather than at the end of the cycle so the backtrace names the caller
+        esp_rom_printf("HEAP_GUARD %u-byte allocation in the control task\n", static_cast<unsigned>(size));
+        abort();
+    }
+}
+
+extern "C" void* __wrap_malloc(size_t size) {
+    noteAllocation(size);
+    return __real_malloc(size);
+}
+
+extern "C" void* __wrap_calloc(size_t count, size_t size) {
+    noteAllocation(count * size);
+    return __real_calloc(count, size);
+}
+
+extern "C" void* __wrap_realloc(void* pointer, size_t size) {
+    noteAllocation(size);
+    return __real_realloc(pointer, size);
+}
+
+void HeapGuard::watchCurrentTask() {
+    watchedTask = xTaskGetCurrentTaskHandle();
+}
+
+void HeapGuard::endCycle() {
+    if (armed || ++cycles < BOOT_CYCLES) {
+        return;
+    }
+    uart.sendData("HEAP_GUARD_BOOT_ALLOCATIONS", static_cast<unsigned long>(allocationCount));
+    armed = true;
+}
+
+uint32_t HeapGuard::allocations() const {
+    return allocationCount;
+}
+
+#endif
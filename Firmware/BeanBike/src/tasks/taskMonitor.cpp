@@ -0,0 +1,46 @@
+#include <Arduino.h>
+#include "taskMonitor.h"
+#include "FixedString.h"
+#include "globals.h"
+
+void TaskMonitor::registerTask(TaskId id, const char* name, TaskHandle_t handle) {
+    TaskSlot& slot = slots[static_cast<int>(id)];
+    slot.name = name;
+    slot.handle = handle;
+}
+
+void TaskMonitor::beginWork(TaskId id) {
+    slots[static_cast<int>(id)].workStartMicros = micros();
+}
+
+void TaskMonitor::endWork(TaskId id) {
+    TaskSlot& slot = slots[static_cast<int>(id)];
+    slot.busyMicros += micros() - slot.workStartMicros;
+}
+
+void TaskMonitor::report() {
+    const uint32_t nowMicros = micros();
+    const uint32_t windowMicros = nowMicros - windowStartMicros;
+    windowStartMicros = nowMicros;
+    if (windowMicros == 0) {
+        return;
+    }
+
+    for (TaskSlot& slot : slots) {
+        if (slot.handle == nullptr) {
+            continue;
+        }
+        // busyMicros only grows; the difference since the last report is this window's work
+        const uint32_t busy = slot.busyMicros;
+        const float loadPercent = 100.0f * (busy - slot.reportedBusyMicros) / windowMicros;
+        slot.reportedBusyMicros = busy;
+
+        FixedString<TelemetryRecord::NAME_LENGTH> name;
+        name.appendf("TASK_LOAD_%s", slot.name);
+        uart.sendData(name.c_str(), loadPercent, 1);
+        name.clear();
+        name.appendf("TASK_STACK_FREE_%s", slot.name);
+        uart.sendData(name.c_str(), uxTaskGetStackHighWaterMark(slot.handle));
+    }
+    uart.sendData("TELEMETRY_DROPPED", telemetry.dropped());
+}
@@ -0,0 +1,68 @@
+#include <unity.h>
+#include "adcTable.h"
+
+static const size_t TABLE_SIZE = 4096;
+static uint16_t table[TABLE_SIZE];
+
+// Linear part of the IDF's ADC1 11 dB characterization: (coeff_a * raw + coeff_b) / 65536,
+// with typical eFuse two-point coefficients
+static uint32_t linearModel(uint32_t raw) {
+    const uint32_t coeffA = 53747;
+    const uint32_t coeffB = 142;
+    return (coeffA * raw + 32768) / 65536 + coeffB;
+}
+
+void setUp() {}
+void tearDown() {}
+
+static void test_endpoints_match_the_converter() {
+    buildCountTable(table, TABLE_SIZE, linearModel);
+    TEST_ASSERT_EQUAL_UINT16(linearModel(0), table[0]);
+    TEST_ASSERT_EQUAL_UINT16(linearModel(TABLE_SIZE - 1), table[TABLE_SIZE - 1]);
+}
+
+static void test_table_is_monotonic() {
+    buildCountTable(table, TABLE_SIZE, linearModel);
+    for (size_t raw = 1; raw < TABLE_SIZE; ++raw) {
+        TEST_ASSERT_TRUE(table[raw] >= table[raw - 1]);
+    }
+}
+
+static void test_converter_wobble_is_flattened() {
+    // Curve that dips by 3 mV every 256 counts, as a piecewise correction can at a segment edge
+    buildCountTable(table, TABLE_SIZE, [](uint32_t raw) {
+        return linearModel(raw) - ((raw % 256 == 0 && raw > 0) ? 3u : 0u);
+    });
+    for (size_t raw = 1; raw < TABLE_SIZE; ++raw) {
+        TEST_ASSERT_TRUE(table[raw] >= table[raw - 1]);
+    }
+    TEST_ASSERT_EQUAL_UINT16(linearModel(TABLE_SIZE - 1), table[TABLE_SIZE - 1]);
+}
+
+static void test_out_of_range_values_saturate() {
+    buildCountTable(table, TABLE_SIZE, [](uint32_t raw) { return raw * 100u; });
+    TEST_ASSERT_EQUAL_UINT16(0, table[0]);
+    TEST_ASSERT_EQUAL_UINT16(UINT16_MAX, table[TABLE_SIZE - 1]);
+}
+
+static int runUnityTests() {
+    UNITY_BEGIN();
+    RUN_TEST(test_endpoints_match_the_converter);
+    RUN_TEST(test_table_is_monotonic);
+    RUN_TEST(test_converter_wobble_is_flattened);
+    RUN_TEST(test_out_of_range_values_saturate);
+    return UNITY_END();
+}
+
+#ifdef ARDUINO
+#include <Arduino.h>
+void setup() {
+    delay(2000);  // Let the serial monitor attach before the results are printed
+    runUnityTests();
+}
+void loop() {}
+#else
+int main() {
+    return runUnityTests();
+}
+#endif
@@ -0,0 +1,67 @@
+#include <unity.h>
+#include "pins.h"
+
+// Host only: without ARDUINO the GPIO banks are the FastGpio mock, not the real registers
+
+void setUp() {
+    FastGpio::mockBanks() = FastGpio::MockBanks();
+}
+void tearDown() {}
+
+static void test_pin_reads_its_own_bit() {
+    FastGpio::setMockInput(15, true);
+    TEST_ASSERT_TRUE(FastPin<15>::read());
+    TEST_ASSERT_FALSE(FastPin<14>::read());
+    TEST_ASSERT_FALSE(FastPin<16>::read());
+
+    FastGpio::setMockInput(15, false);
+    TEST_ASSERT_FALSE(FastPin<15>::read());
+}
+
+static void test_high_bank_pins_read_bank_one() {
+    FastGpio::setMockInput(39, true);
+    TEST_ASSERT_TRUE(FastPin<39>::read());
+    TEST_ASSERT_FALSE(FastPin<7>::read());  // Same bit position in bank 0
+    TEST_ASSERT_EQUAL_UINT32(0, FastGpio::readInputs(false));
+}
+
+static void test_write_sets_and_clears_only_its_pin() {
+    FastPin<13>::write(true);
+    FastPin<33>::write(true);
+    TEST_ASSERT_TRUE(FastGpio::mockOutput(13));
+    TEST_ASSERT_TRUE(FastGpio::mockOutput(33));
+
+    FastPin<13>::write(false);
+    TEST_ASSERT_FALSE(FastGpio::mockOutput(13));
+    TEST_ASSERT_TRUE(FastGpio::mockOutput(33));
+}
+
+static void test_group_packs_first_pin_as_bit_zero() {
+    typedef FastPinGroup<11, 4, 9> Group;
+    FastGpio::setMockInput(11, true);
+    TEST_ASSERT_EQUAL_UINT8(0x1, Group::read());
+    FastGpio::setMockInput(11, false);
+    FastGpio::setMockInput(9, true);
+    TEST_ASSERT_EQUAL_UINT8(0x4, Group::read());
+}
+
+static void test_hall_code_is_a_b_c_from_bit_zero() {
+    // Commutation tables index sectors by this code, so A must stay bit 0 and C bit 2
+    const int halls[3] = {Pins::MOTOR_HALL_A.pin, Pins::MOTOR_HALL_B.pin, Pins::MOTOR_HALL_C.pin};
+    for (uint8_t code = 0; code < 8; ++code) {
+        for (int bit = 0; bit < 3; ++bit) {
+            FastGpio::setMockInput(halls[bit], (code >> bit) & 1u);
+        }
+        TEST_ASSERT_EQUAL_UINT8(code, HallInputs::read());
+    }
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_pin_reads_its_own_bit);
+    RUN_TEST(test_high_bank_pins_read_bank_one);
+    RUN_TEST(test_write_sets_and_clears_only_its_pin);
+    RUN_TEST(test_group_packs_first_pin_as_bit_zero);
+    RUN_TEST(test_hall_code_is_a_b_c_from_bit_zero);
+    return UNITY_END();
+}
@@ -0,0 +1,28 @@
+// Host-side DRV8353 register pretty-printer, built from the same field map as the firmware.
+//
+//   g++ -std=gnu++11 -Iinclude tools/drvdecode/drvdecode.cpp src/DRV8353/drvRegisterMap.cpp -o drvdecode
+//   ./drvdecode 0x06 0x283 0x00 0x420
+//
+// Arguments are address/value pairs; values may be raw 16-bit SPI responses.
+#include <stdio.h>
+#include <stdlib.h>
+#include "drvRegisterMap.h"
+
+int main(int argc, char** argv) {
+    if (argc < 3 || (argc - 1) % 2 != 0) {
+        fprintf(stderr, "usage: %s <address> <value> [<address> <value> ...]\n", argv[0]);
+        return 1;
+    }
+    for (int i = 1; i + 1 < argc; i += 2) {
+        const unsigned long address = strtoul(argv[i], nullptr, 0);
+        const uint16_t value = static_cast<uint16_t>(strtoul(argv[i + 1], nullptr, 0)) & DrvRegs::DATA_MASK;
+        if (address >= DrvRegs::REGISTER_COUNT) {
+            fprintf(stderr, "unknown register 0x%02lX\n", address);
+            return 1;
+        }
+        char text[256];
+        DrvRegs::formatRegister(static_cast<uint8_t>(address), value, text, sizeof(text));
+        printf("%s (0x%03X): %s\n", DrvRegs::REGISTERS[address].name, value, text);
+    }
+    return 0;
+}